@@ -9,6 +9,7 @@ in vec3 fragNormal;
 // Input uniform values
 uniform sampler2D texture0;
 uniform vec4 colDiffuse;
+uniform vec4 atlasRect;     // layer offset (xy) and size (zw) in the texture atlas
 
 // Output fragment color
 out vec4 finalColor;
@@ -38,41 +39,124 @@ uniform Light lights[MAX_LIGHTS];
 uniform vec4 ambient;
 uniform vec3 viewPos;
 
+// Specialised builds get LIGHTn_TYPE defined for each enabled light
+// (see lighting.c) so the loop, the enabled test and the type test all
+// go away, CHEAP_LIGHTING drops specular for distant LODs. With neither
+// this is the generic shader driven by the light uniforms.
+#if defined(LIGHT0_TYPE) || defined(LIGHT1_TYPE) || defined(LIGHT2_TYPE) || defined(LIGHT3_TYPE)
+#define SPECIALISED_LIGHTS
+#endif
+
+void applyLight(int i, int type, vec3 normal, vec3 viewD, inout vec3 lightDot, inout vec3 specular)
+{
+    vec3 light;
+    if (type == LIGHT_DIRECTIONAL) {
+        light = -normalize(lights[i].target - lights[i].position);
+    } else {
+        light = normalize(lights[i].position - fragPosition);
+    }
+    float NdotL = max(dot(normal, light), 0.0);
+    lightDot += lights[i].color.rgb * NdotL;
+
+#ifndef CHEAP_LIGHTING
+    // x^16 (shine) by squaring, cheaper than pow and the same result
+    float specCo = max(0.0, dot(viewD, reflect(-light, normal)));
+    specCo *= specCo;
+    specCo *= specCo;
+    specCo *= specCo;
+    specCo *= specCo;
+    specular += (NdotL > 0.0) ? vec3(specCo) : vec3(0.0);
+#endif
+}
+
+#ifdef CLUSTERED
+// point lights binned per view space cluster on the CPU (clusters.c)
+uniform sampler2D clusterGrid;      // per cluster: first index, count
+uniform sampler2D clusterIndices;   // light numbers
+uniform sampler2D clusterLights;    // per light: position + radius, color
+uniform vec2 screenSize;
+
+void applyClusteredLights(vec3 normal, vec3 viewD, inout vec3 lightDot, inout vec3 specular)
+{
+    // linear depth back from the depth buffer value
+    float n = CLUSTER_NEAR_PLANE;
+    float f = CLUSTER_FAR_PLANE;
+    float depth = (2.0 * n * f) / (f + n - (gl_FragCoord.z * 2.0 - 1.0) * (f - n));
+    int slice = int(clamp(log(depth / CLUSTER_DEPTH_NEAR) * (float(CLUSTER_Z) / log(CLUSTER_DEPTH_FAR / CLUSTER_DEPTH_NEAR)),
+                          0.0, float(CLUSTER_Z - 1)));
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / screenSize * vec2(CLUSTER_X, CLUSTER_Y)),
+                       ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+
+    vec4 cell = texelFetch(clusterGrid, ivec2(tile.x + tile.y * CLUSTER_X, slice), 0);
+    int first = int(cell.x);
+    int count = int(cell.y);
+    for (int i = first; i < first + count; i++)
+    {
+        int l = int(texelFetch(clusterIndices, ivec2(i % CLUSTER_INDEX_WIDTH, i / CLUSTER_INDEX_WIDTH), 0).r);
+        vec4 posRadius = texelFetch(clusterLights, ivec2(0, l), 0);
+        vec3 color = texelFetch(clusterLights, ivec2(1, l), 0).rgb;
+
+        vec3 light = posRadius.xyz - fragPosition;
+        float dist = length(light);
+        float atten = clamp(1.0 - dist / posRadius.w, 0.0, 1.0);
+        atten *= atten;
+        light /= dist;
+        float NdotL = max(dot(normal, light), 0.0);
+        lightDot += color * (NdotL * atten);
+
+#ifndef CHEAP_LIGHTING
+        float specCo = max(0.0, dot(viewD, reflect(-light, normal)));
+        specCo *= specCo;
+        specCo *= specCo;
+        specCo *= specCo;
+        specCo *= specCo;
+        specular += (NdotL > 0.0) ? color * (specCo * atten) : vec3(0.0);
+#endif
+    }
+}
+#endif
+
 void main()
 {
-    // Texel color fetching from texture sampler
-    vec4 texelColor = texture(texture0, fragTexCoord);
+    // Texel color fetching from the atlas layer, wrapping inside the layer,
+    // gradients come from the unwrapped coords so fract doesn't upset mipmapping
+    vec2 atlasCoord = atlasRect.xy + fract(fragTexCoord) * atlasRect.zw;
+    vec4 texelColor = textureGrad(texture0, atlasCoord,
+                                  dFdx(fragTexCoord) * atlasRect.zw, dFdy(fragTexCoord) * atlasRect.zw);
     vec3 lightDot = vec3(0.0);
     vec3 normal = normalize(fragNormal);
     vec3 viewD = normalize(viewPos - fragPosition);
     vec3 specular = vec3(0.0);
 
-    // NOTE: Implement here your fragment shader code
-
+#ifdef SPECIALISED_LIGHTS
+#ifdef LIGHT0_TYPE
+    applyLight(0, LIGHT0_TYPE, normal, viewD, lightDot, specular);
+#endif
+#ifdef LIGHT1_TYPE
+    applyLight(1, LIGHT1_TYPE, normal, viewD, lightDot, specular);
+#endif
+#ifdef LIGHT2_TYPE
+    applyLight(2, LIGHT2_TYPE, normal, viewD, lightDot, specular);
+#endif
+#ifdef LIGHT3_TYPE
+    applyLight(3, LIGHT3_TYPE, normal, viewD, lightDot, specular);
+#endif
+#elif !defined(NO_LIGHTS)
     for (int i = 0; i < MAX_LIGHTS; i++)
     {
-        if (lights[i].enabled == 1)
-        {
-            vec3 light = vec3(0.0);
-            if (lights[i].type == LIGHT_DIRECTIONAL) {
-                light = -normalize(lights[i].target - lights[i].position);
-            }
-            if (lights[i].type == LIGHT_POINT) {
-                light = normalize(lights[i].position - fragPosition);
-            }
-            float NdotL = max(dot(normal, light), 0.0);
-            lightDot += lights[i].color.rgb * NdotL;
-
-            float specCo = 0.0;
-            if(NdotL > 0.0)
-                specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16);//16 =shine
-            specular += specCo;
-
-        }
+        if (lights[i].enabled == 1) applyLight(i, lights[i].type, normal, viewD, lightDot, specular);
     }
+#endif
+#ifdef CLUSTERED
+    applyClusteredLights(normal, viewD, lightDot, specular);
+#endif
 
     finalColor =  (texelColor * ((colDiffuse+vec4(specular,1)) * vec4(lightDot, 1.0)));
     finalColor += texelColor * (ambient/10.0);
     // gamma
-    finalColor = pow(finalColor, vec4(1.0/2.2));
+#ifdef CHEAP_LIGHTING
+    finalColor.rgb = sqrt(finalColor.rgb);      // 2.0 is close enough far away
+#else
+    finalColor.rgb = pow(finalColor.rgb, vec3(1.0/2.2));
+#endif
 }
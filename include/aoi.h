@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef AOI_H
+#define AOI_H
+
+#include <stdbool.h>
+#include "raylib.h"
+#include <ode/ode.h>
+
+struct PhysicsContext;
+
+// Area of interest - the world is cut into AOI_CELL_SIZE cells and only
+// bodies in cells near a point of interest (the camera, a controller) are
+// simulated. Everything else is frozen: disabled and its geoms moved out
+// of the collision space into one that is never collided, so it costs
+// neither the broadphase nor the solver. Thawing puts the geoms back and
+// restores each body's enabled state, velocities were never touched.
+// Ragdolls and vehicles go as one, by their centre / chassis.
+#define AOI_CELL_SIZE 10.0f
+#define AOI_RADIUS 2                // cells either side of a point that stay live
+#define AOI_MAX_POINTS 8
+#define AOI_UPDATE_STEPS 30         // steps between passes
+
+typedef struct FrozenBody {
+    dBodyID body;
+    bool enabled;               // as it was when frozen
+} FrozenBody;
+
+typedef struct AreaOfInterest {
+    bool enabled;
+    Vector3 points[AOI_MAX_POINTS];
+    int pointCount;
+    dSpaceID frozen;            // the geoms of frozen bodies, never collided
+    FrozenBody* bodies;
+    int frozenCount;
+    int capacity;
+    int activeCount;            // bodies left in the collision space
+} AreaOfInterest;
+
+bool InitAreaOfInterest(AreaOfInterest* aoi);
+// thaw first (ThawAll) so the geoms are back where their owners expect
+void FreeAreaOfInterest(AreaOfInterest* aoi);
+
+// Freeze / thaw against the current points, every AOI_UPDATE_STEPS
+// steps. Call before colliding
+void UpdateAreaOfInterest(struct PhysicsContext* ctx);
+void ThawAll(struct PhysicsContext* ctx);
+// call before destroying a body or giving its geoms to another, so
+// the frozen list never holds a dead body
+void ThawBody(struct PhysicsContext* ctx, dBodyID body);
+
+// share of the dynamic bodies being simulated, 0..1
+float AreaOfInterestActiveFraction(const AreaOfInterest* aoi);
+
+#endif // AOI_H
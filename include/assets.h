@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdint.h>
+#include "raylib.h"
+
+// Asset pack - everything InitGraphics needs, already decoded, in one
+// file that's mapped rather than read. Built offline with --pack-assets,
+// if it's missing the source files are decoded on worker threads instead.
+#define ASSET_PACK_FILE "data/assets.pack"
+#define ASSET_PACK_MAGIC 0x4b504152u        // "RAPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGN 64                 // payload alignment in the file
+
+typedef enum {
+    ASSET_IMAGE = 1,        // raw pixels, width * height in format
+    ASSET_MESH,             // triangles: vertices (3f) texcoords (2f) normals (3f) per vertex
+    ASSET_TEXT              // NUL terminated
+} AssetType;
+
+typedef struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;         // entries following the header
+    uint32_t pad;
+} AssetPackHeader;
+
+typedef struct AssetEntry {
+    char name[48];
+    uint32_t type;
+    int32_t width;          // image size / mesh vertex count in width
+    int32_t height;
+    int32_t format;
+    uint64_t offset;        // from the start of the file
+    uint64_t size;
+} AssetEntry;
+
+// The CPU side of the startup assets, ready for uploading
+typedef struct AssetSet {
+    Image atlas;            // composed texture atlas (level 0)
+    Mesh cylinder;          // data/cylinder.obj (CPU arrays only)
+    char* lightVs;
+    char* lightFs;
+
+    void* map;              // the pack when it's mapped, data points into it
+    size_t mapSize;
+    size_t accounted;       // bytes charged to MEM_ASSETS
+} AssetSet;
+
+// Fill set from the pack, or from the source files if there's no (usable)
+// pack, decoding on worker threads either way. The mesh arrays are owned
+// by the caller afterwards (LoadModelFromMesh takes them).
+bool LoadAssets(AssetSet* set);
+void UnloadAssets(AssetSet* set);
+
+// Offline step - decode the sources and write the pack, no window needed
+// (.obj files go through our own parser rather than LoadModel)
+bool PackAssets(const char* fileName);
+
+#endif // ASSETS_H
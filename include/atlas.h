@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+
+// Every primitive texture lives in one atlas so a whole frame
+// can be drawn without changing the texture binding
+typedef enum {
+    ATLAS_BALL = 0,         // ball.png
+    ATLAS_BEACH_BALL,       // beach-ball.png
+    ATLAS_EARTH,            // earth.png
+    ATLAS_CRATE,            // crate.png
+    ATLAS_GRID,             // grid.png
+    ATLAS_DRUM,             // drum.png
+    ATLAS_CYLINDER,         // cylinder2.png
+    ATLAS_GRASS,            // grass.png
+    ATLAS_LAYER_COUNT
+} AtlasLayer;
+
+#define ATLAS_LAYER_SIZE 512
+// wrapped border round each layer so filtering and the
+// smaller mip levels don't pick up the neighbouring layer
+#define ATLAS_GUTTER 16
+#define ATLAS_COLUMNS 4
+
+typedef struct TextureAtlas {
+    Texture texture;
+    Vector4 rects[ATLAS_LAYER_COUNT];   // uv offset (xy) and size (zw) of each layer
+} TextureAtlas;
+
+// Pack the data/ textures into a single mipmapped texture
+bool LoadTextureAtlas(TextureAtlas* atlas);
+
+// The same in stages - decode a layer (RGBA, layer size, safe on any
+// thread), compose decoded layers into the atlas image, then upload
+// an atlas image (main thread, the image is left for the caller)
+const char* AtlasLayerFile(int layer);
+Image LoadAtlasLayer(int layer);
+Image BuildAtlasImage(const Image* layers);
+void LoadTextureAtlasFromImage(TextureAtlas* atlas, Image img);
+void UnloadTextureAtlas(TextureAtlas* atlas);
+
+#endif // ATLAS_H
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "raylib.h"
+
+// Offscreen capture - the scene is drawn into a render texture, read back
+// through a ring of pixel buffer objects so glReadPixels doesn't wait for
+// the frame to finish, then handed to a writer thread for the disk I/O.
+#define CAPTURE_PBO_COUNT 3         // readbacks in flight
+#define CAPTURE_QUEUE_SIZE 8        // frames waiting for the writer, more are dropped
+
+typedef enum {
+    CAPTURE_RAW,                    // one file of RGBA frames, top row first
+    CAPTURE_PNG                     // a numbered png per frame
+} CaptureFormat;
+
+typedef struct Capture {
+    RenderTexture2D target;
+    int width;
+    int height;
+    CaptureFormat format;
+    char dir[256];
+
+    unsigned int pbos[CAPTURE_PBO_COUNT];
+    void* fences[CAPTURE_PBO_COUNT];        // GLsync
+    int pboTail;                            // oldest readback in flight
+    int pboPending;
+
+    // frames[queueHead] onwards (queued of them) belong to the writer
+    unsigned char* frames[CAPTURE_QUEUE_SIZE];
+    long frameNumbers[CAPTURE_QUEUE_SIZE];
+    int queueHead;
+    int queued;
+    bool stopping;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    FILE* raw;
+
+    long captured;                          // frames read back
+    long written;
+    long dropped;                           // writer fell behind
+} Capture;
+
+// Needs a GL context, dir is created if it's missing
+bool InitCapture(Capture* cap, int width, int height, CaptureFormat format, const char* dir);
+
+// Draw the scene between these, EndCapture starts the frame's readback
+// and queues any earlier frames that have arrived
+void BeginCapture(Capture* cap);
+void EndCapture(Capture* cap);
+
+// Waits for the readbacks in flight and the writer to finish
+void FreeCapture(Capture* cap);
+
+#endif // CAPTURE_H
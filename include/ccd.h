@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CCD_H
+#define CCD_H
+
+#include <ode/ode.h>
+
+struct PhysicsContext;
+
+// Continuous collision for fast bodies, so the world can be stepped
+// coarser than PHYS_SLICE. Any awake body that would travel more than
+// CCD_TRAVEL_FRACTION of its thickness in one step has its path swept
+// (a ray from its centre) against the space, stopping a thickness short.
+// If that hits something the approach speed along the hit normal is
+// cut so the body only just reaches the surface this step, and the
+// normal contacts take over on the next - conservative advancement
+// done with the velocity rather than sub stepping the body.
+#define CCD_TRAVEL_FRACTION 0.5f
+#define CCD_MARGIN 0.9f             // of the gap that may be closed in one step
+
+// Call between colliding and stepping the world, returns the number of
+// bodies slowed down
+int ClampFastBodies(struct PhysicsContext* ctx, float slice);
+
+#endif // CCD_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CLUSTERS_H
+#define CLUSTERS_H
+
+#include "raylib.h"
+
+// Clustered forward lighting - point lights are binned on the CPU into
+// view space froxels each frame, the shader then only loops over the
+// lights in its own cluster. The dimensions are passed to simpleLight.fs
+// as defines when it's built with CLUSTERED (see lighting.c).
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define CLUSTER_COUNT (CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
+
+// depth slices are exponential from CLUSTER_DEPTH_NEAR, anything
+// further than CLUSTER_DEPTH_FAR shares the last slice
+#define CLUSTER_DEPTH_NEAR 1.0f
+#define CLUSTER_DEPTH_FAR 200.0f
+
+#define MAX_POINT_LIGHTS 1024
+#define CLUSTER_INDEX_WIDTH 1024            // light index texture is this wide
+#define MAX_CLUSTER_INDICES (CLUSTER_INDEX_WIDTH * 128)
+
+// texture units used for the cluster data, clear of the material maps
+#define CLUSTER_TEXTURE_SLOT 13
+
+typedef struct PointLight {
+    Vector3 position;
+    float radius;           // light reaches zero at this distance
+    Vector3 color;
+} PointLight;
+
+typedef struct ClusterLighting {
+    PointLight lights[MAX_POINT_LIGHTS];
+    int count;
+
+    // per frame CPU side data, uploaded to the matching textures
+    float* lightData;       // 2 RGBA texels per light: position + radius, color
+    float* gridData;        // RGBA per cluster: first index, light count
+    float* indexData;       // R per entry: light number
+    int indexCount;         // used entries this frame
+    int overflow;           // entries dropped this frame (index texture full)
+
+    unsigned int lightTex;
+    unsigned int gridTex;
+    unsigned int indexTex;
+} ClusterLighting;
+
+// Create the data textures, needs a GL context
+bool InitClusterLighting(ClusterLighting* cl);
+
+// Returns the new light's number or -1 if there's no room
+int AddPointLight(ClusterLighting* cl, Vector3 position, float radius, Color color);
+
+// Bin the lights for this camera and upload everything
+void UpdateClusterLighting(ClusterLighting* cl, Camera camera, float aspect);
+
+// Bind the data textures ready for a CLUSTERED shader
+void BindClusterLighting(const ClusterLighting* cl);
+
+void FreeClusterLighting(ClusterLighting* cl);
+
+#endif // CLUSTERS_H
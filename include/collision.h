@@ -34,4 +34,15 @@ struct PhysicsContext;
 // data is expected to be a struct PhysicsContext*
 void nearCallback(void *data, dGeomID o1, dGeomID o2);
 
+// With the context's deterministic flag set nearCallback only queues
+// the pairs, this sorts them by geom serial and collides them in that
+// order, so contacts (and trigger events) come out the same way each
+// run whatever order the broadphase found them in
+void CollideQueuedPairs(struct PhysicsContext* ctx);
+
+// Keep at most budget of count contacts, reordered to the front: the
+// deepest, the one furthest from it, then the ones spanning the most
+// area. Returns how many are left
+int ReduceContacts(dContact* contact, int count, int budget);
+
 #endif // COLLISION_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#include <ode/ode.h>
+
+// Temporal coherence for the narrow phase - each pair's contacts are kept
+// (in the first geom's frame) for one step, if the pair comes back from the
+// broadphase with its relative pose within tolerance the old contacts are
+// moved to where the first geom is now instead of calling dCollide again.
+// The pose compared against is the one dCollide last ran at, so reuse can't
+// creep more than the tolerance away from a real result.
+#define CONTACT_CACHE_POINTS 8          // contacts kept per pair
+#define CONTACT_CACHE_SLOTS 4096        // per table, power of 2
+#define CONTACT_CACHE_LINEAR_TOL 0.001f // relative movement, in metres
+#define CONTACT_CACHE_ANGULAR_TOL 0.004f // relative rotation, in radians
+
+typedef struct CachedContact {
+    float pos[3];               // in g1's frame
+    float normal[3];
+    float depth;
+    int side1, side2;
+} CachedContact;
+
+typedef struct ContactCacheEntry {
+    dGeomID g1, g2;
+    unsigned int step;          // entry is live when this is its table's step
+    int count;
+    float relPos[3];            // g2 in g1's frame when dCollide ran
+    float relQ[4];
+    CachedContact contacts[CONTACT_CACHE_POINTS];
+} ContactCacheEntry;
+
+// Two tables, pairs seen this step go in one while the other has the
+// last step's, swapping each step drops pairs the broadphase didn't
+// report without any sweeping
+typedef struct ContactCache {
+    ContactCacheEntry* tables[2];
+    int current;
+    unsigned int step;
+    int used;                   // entries in the current table
+    int hits;                   // pairs this step that skipped dCollide
+} ContactCache;
+
+bool InitContactCache(ContactCache* cache);
+void FreeContactCache(ContactCache* cache);
+
+// Call before each dSpaceCollide
+void ContactCacheBeginStep(ContactCache* cache);
+
+// Forget every pair, for when geoms are destroyed (their addresses
+// could come back as new geoms)
+void ClearContactCache(ContactCache* cache);
+
+// Forget one geom's pairs, call before destroying it or moving it to
+// another world's space
+void ContactCacheForgetGeom(ContactCache* cache, dGeomID g);
+
+// dCollide through the cache, same arguments and result
+int CollideCached(ContactCache* cache, dGeomID o1, dGeomID o2, int max, dContactGeom* contact, int skip);
+
+#endif // CONTACTCACHE_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FORCEFIELD_H
+#define FORCEFIELD_H
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+
+typedef enum {
+    FORCEFIELD_EXPLOSION = 0,   // radial push away from position, falls off to zero at radius
+    FORCEFIELD_WIND,            // constant push along direction inside the box
+    FORCEFIELD_LIFT             // upward push inside the box with some sideways jitter
+} ForceFieldType;
+
+// what a field is allowed to push
+#define FORCEFIELD_OBJECTS  1
+#define FORCEFIELD_RAGDOLLS 2
+
+typedef struct ForceField {
+    ForceFieldType type;
+    int targets;                // FORCEFIELD_OBJECTS | FORCEFIELD_RAGDOLLS
+    Vector3 position;           // explosion centre or centre of the box
+    Vector3 extents;            // half size of the box (wind, lift)
+    float radius;               // explosion radius
+    Vector3 direction;          // wind direction (normalised)
+    float strength;             // acceleration in m/s/s, scaled by mass so heavy things move too
+    float jitter;               // random sideways acceleration (lift)
+    float maxSpeed;             // leave alone anything already this fast along the field (0 = no cap)
+} ForceField;
+
+// Most bodies found by a single field query, any more are ignored
+#define FORCEFIELD_MAX_BODIES 1024
+
+// Push everything the field overlaps, ragdolls are pushed as a whole
+// using their cached aggregates, returns how many objects / dolls were hit
+int ApplyForceField(PhysicsContext* ctx, const ForceField* field);
+
+#endif // FORCEFIELD_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef HUD_H
+#define HUD_H
+
+#include "raylib.h"
+#include "memtrack.h"
+
+// Performance overlay - every timing keeps its last HUD_HISTORY frames
+// and is shown as min/avg/max plus a sparkline, so a spike stays on
+// screen long enough to see what else moved with it.
+#define HUD_HISTORY 240
+
+typedef enum {
+    HUD_FRAME_MS,           // GetFrameTime
+    HUD_PHYSICS_MS,         // all the physics steps in a frame
+    HUD_DRAW_MS,            // CPU side of drawing the scene
+    HUD_STEPS,              // physics steps per frame
+    HUD_SERIES_COUNT
+} HudSeriesId;
+
+typedef enum {
+    HUD_PAIRS,              // candidate pairs from the broadphase, last step
+    HUD_CACHED,             // of those, pairs the contact cache answered
+    HUD_CONTACTS,           // contact joints, last step
+    HUD_AWAKE,              // enabled bodies
+    HUD_CCD,                // of those, slowed down by the sweep, last step
+    HUD_ACTIVE_PERCENT,     // bodies outside frozen cells
+    HUD_DRAW_CALLS,
+    HUD_STEP_MEMORY_KB,     // peak ODE working memory
+    HUD_PEAK_CONTACTS,
+    HUD_RESERVED_CONTACTS,  // contact group size once warmed up
+    HUD_STEP_ALLOCS,        // working memory allocations after the reservation
+    HUD_RAGDOLLS,           // for the per doll footprint
+    HUD_COUNT_COUNT
+} HudCountId;
+
+typedef struct HudSeries {
+    float samples[HUD_HISTORY];     // ring, newest at head - 1
+    int head;
+    int count;
+    float min, avg, max;
+} HudSeries;
+
+// A line of text that's only formatted again when its values change
+typedef struct HudLine {
+    float values[4];
+    bool valid;
+    char text[96];
+} HudLine;
+
+typedef struct Hud {
+    HudSeries series[HUD_SERIES_COUNT];
+    int counts[HUD_COUNT_COUNT];
+    HudLine seriesLines[HUD_SERIES_COUNT];
+    HudLine countLines[3];
+    HudLine memoryLines[MEM_TAG_COUNT + 1];     // total then one per tag
+} Hud;
+
+void InitHud(Hud* hud);
+
+// Add this frame's sample to a series
+void HudPush(Hud* hud, HudSeriesId id, float value);
+
+// Formats with up to 4 float values (so counts want %.0f), the previous
+// text is returned as is if none of the values changed
+const char* HudLineText(HudLine* line, const char* fmt, int count, const float* values);
+
+// Stats text and graphs, all the graph lines go in one batch
+void DrawHud(Hud* hud, int x, int y);
+
+#endif // HUD_H
@@ -28,29 +28,112 @@
 #include <ode/ode.h>
 #include "raylibODE.h"
 #include "rlights.h"
+#include "atlas.h"
+#include "lighting.h"
+#include "clusters.h"
+
+// Detail levels per primitive, 0 is the full mesh
+#define GEOM_LOD_COUNT 4
+
+// View frustum as inward facing planes (xyz normal, w distance)
+typedef struct Frustum {
+    Vector4 planes[6];
+} Frustum;
+
+// One queued mesh draw, sorted so state changes are grouped
+typedef struct DrawItem {
+    LightingShader* lighting;
+    Mesh* mesh;
+    Material* material;
+    int layer;
+    Vector2 uvScale;
+    Matrix transform;
+} DrawItem;
+
+// A geom whose model matrix is built at flush time, along with the
+// rest of the queue's, rather than one at a time while queueing
+typedef struct PendingTransform {
+    geomInfo* gi;           // transform cache to fill, NULL if none
+    int firstItem;          // its draw items, before they're sorted
+    int itemCount;
+    bool lodBase;           // cylinder LOD meshes need the base rotation
+    bool asleep;
+    unsigned int step;
+} PendingTransform;
+
+typedef struct DrawQueue {
+    DrawItem* items;
+    int count;
+    int capacity;
+
+    // ODE poses gathered for one BuildModelMatrices call per flush
+    PendingTransform* pending;
+    float* positions;       // 4 floats each
+    float* rotations;       // 12 floats each
+    Vector3* scales;
+    Matrix* matrices;
+    int pendingCount;
+    int pendingCapacity;
+} DrawQueue;
 
 // Graphics context - holds all rendering resources
 typedef struct GraphicsContext {
     Model box;
-    Model ball;
-    Model cylinder;
+    Model ballLods[GEOM_LOD_COUNT];
+    Model cylinderLods[GEOM_LOD_COUNT];
+    Matrix cylinderLodBase;         // turns the generated cylinders to match the .obj (z axis, centred)
     
-    // Texture arrays for different geometry types
-    Texture sphereTextures[3];      // ball.png, beach-ball.png, earth.png
-    Texture boxTextures[2];         // crate.png, grid.png
-    Texture cylinderTextures[2];    // drum.png, cylinder2.png
-    Texture groundTexture;          // grass.png
+    TextureAtlas atlas;             // every primitive texture, see AtlasLayer
     
-    Shader shader;
+    Shader shader;                  // generic lighting, used if a permutation won't build
+    LightingCache lighting;         // simpleLight specialised for the enabled lights
+    ClusterLighting* clusters;      // point lights, NULL unless clustered lighting is enabled
     Light lights[MAX_LIGHTS];
+
+    // per frame view state, set by SetDrawCamera
+    Camera camera;
+    Frustum frustum;
+    float pixelsPerUnit;            // projected size of 1 unit at distance 1
+    unsigned int physicsStep;       // PhysicsContext stepCount, geoms on enabled bodies
+                                    // only rebuild their matrices when this changes
+    int drawnGeoms;
+    int culledGeoms;
+    int drawCalls;                  // meshes submitted by FlushGeomQueue
+    DrawQueue queue;
 } GraphicsContext;
 
 // Initialize graphics resources and window
 void InitGraphics(GraphicsContext* ctx, int width, int height, const char* title);
 
+// Switch the lighting shaders over to clustered point lights,
+// add lights to ctx->clusters afterwards
+bool EnableClusteredLighting(GraphicsContext* ctx);
+
+// Just the world, the ground and the kill volume, its rng is seed's
+// stream 0
+PhysicsContext* CreatePhysicsWorld(dSpaceID* space, unsigned long seed);
+
 // Initialize the physics world and create all objects
 // Returns pointer to PhysicsContext (caller responsible for passing to CleanupPhysics)
-PhysicsContext* InitPhysics(dSpaceID* space, GraphicsContext* gfxCtx);
+// Everything random about the scene comes from seed
+PhysicsContext* InitPhysics(dSpaceID* space, unsigned long seed);
+
+// Advance the world by one fixed step (collide, step, empty contacts)
+void StepPhysics(PhysicsContext* ctx, float slice);
+
+// Bodies in the space that aren't asleep
+int CountAwakeBodies(dSpaceID space);
+
+// Fold the position, orientation and velocities of every object and
+// doll into an FNV-1a hash, two runs that agree on it agree bit for bit
+unsigned int HashPhysicsState(const PhysicsContext* ctx, unsigned int hash);
+#define PHYSICS_HASH_START 2166136261u
+
+// Teleport simple objects and re-create ragdolls that fell off the ground
+void ResetFallenObjects(PhysicsContext* ctx);
+
+// Clean up physics resources (also done by CleanupGraphics)
+void CleanupPhysics(PhysicsContext* ctx);
 
 // Clean up application resources
 void CleanupGraphics(GraphicsContext* ctx, PhysicsContext* physCtx);
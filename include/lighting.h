@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef LIGHTING_H
+#define LIGHTING_H
+
+#include "raylib.h"
+#include "rlights.h"
+
+// Specialised builds of the simpleLight shader, one per set of
+// enabled lights (and their types), compiled on demand and kept
+#define LIGHTING_CACHE_SIZE 16
+
+typedef enum {
+    LIGHTING_FULL = 0,      // specular, exact gamma
+    LIGHTING_CHEAP,         // diffuse only, used for the far LODs
+    LIGHTING_VARIANTS
+} LightingVariant;
+
+typedef struct LightingShader {
+    unsigned int key;       // enabled light types + variant
+    Shader shader;
+    int texCoordScaleLoc;
+    int atlasRectLoc;
+    int screenSizeLoc;      // CLUSTERED builds only
+} LightingShader;
+
+typedef struct LightingCache {
+    char* vsSource;
+    char* fsSource;
+    LightingShader entries[LIGHTING_CACHE_SIZE];
+    int count;
+    int next;                                   // round robin replacement once full
+    bool clustered;                             // build with the clustered point lights
+    LightingShader* active[LIGHTING_VARIANTS];  // permutations for the current lights
+    LightingShader fallback;                    // the generic shader, if a build fails
+} LightingCache;
+
+// Keeps a copy of the shader sources, call UpdateLighting once the lights exist
+bool InitLighting(LightingCache* cache, const char* vsSource, const char* fsSource);
+
+// Pick (compiling if needed) the permutations matching lights and upload
+// their values, call whenever a light is toggled or changed
+void UpdateLighting(LightingCache* cache, const Light* lights, int count, Shader fallback);
+
+// Per frame camera position for the specular term, and the
+// render target size for finding the light cluster
+void SetLightingView(LightingCache* cache, Vector3 viewPos, Vector2 screenSize);
+
+void FreeLighting(LightingCache* cache);
+
+#endif // LIGHTING_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Memory accounting - our allocations go through MemAlloc and friends
+// with a tag, ODE's through handlers that charge whatever tag is current
+// on the calling thread (MemSetTag). Each block carries a small header
+// with its tag and size so frees are credited back to the right place.
+typedef enum {
+    MEM_OTHER,
+    MEM_ODE,            // ODE allocations outside any tagged scope
+    MEM_GEOMINFO,
+    MEM_RAGDOLLS,       // the RagDoll structs and their ODE bodies, geoms and joints
+    MEM_VEHICLES,
+    MEM_CONTACTS,       // contact joints, the contact cache
+    MEM_TRIGGERS,       // trigger volumes, their body lists and events
+    MEM_SPACES,
+    MEM_STEP,           // ODE's step working memory
+    MEM_ASSETS,
+    MEM_RENDER,         // CPU side rendering buffers
+    MEM_TAG_COUNT
+} MemTag;
+
+typedef struct MemStats {
+    size_t live[MEM_TAG_COUNT];
+    size_t peak[MEM_TAG_COUNT];
+    size_t liveTotal;
+    size_t peakTotal;
+    long allocs;                // calls, frees not counted
+} MemStats;
+
+void* MemAlloc(MemTag tag, size_t size);
+void* MemCalloc(MemTag tag, size_t count, size_t size);
+void* MemRealloc(MemTag tag, void* ptr, size_t size);   // ptr keeps its original tag
+void MemFree(void* ptr);
+
+// ODE allocations on this thread are charged to tag until it's set
+// again, returns the tag it replaces
+MemTag MemSetTag(MemTag tag);
+
+// Route ODE's allocator through the accounting, must happen before
+// dInitODE2 (anything ODE allocated earlier would be freed without a header)
+void MemHookODE(void);
+
+// For memory someone else allocates, eg raylib images, + on load - on unload
+void MemAccount(MemTag tag, long bytes);
+
+void MemGetStats(MemStats* stats);
+const char* MemTagName(MemTag tag);
+
+// One line per tag that's been used, through printf
+void MemPrintReport(const char* prefix);
+
+#endif // MEMTRACK_H
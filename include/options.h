@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdbool.h>
+
+// Command line options - the defaults run the interactive demo
+typedef struct AppOptions {
+    bool headless;              // physics only, no window or rendering
+    int shards;                 // headless: split the scene over this many worlds (see shard.h)
+    int workers;                // shards: threads stepping them (0 = one per shard)
+    unsigned long seed;         // everything random in the scene comes from this (0 = the clock)
+    bool deterministic;         // headless: bit for bit the same run for a seed, whatever the workers
+    long steps;                 // headless: physics steps to run (0 = until the client detaches)
+    const char* shmName;        // headless: serve a controller over this POSIX shm segment
+    int benchVehicles;          // headless: add a fleet of this many vehicles driving about
+    int benchLights;            // windowed: add this many clustered point lights, time 600 frames and exit
+    int benchTransforms;        // time the model matrix kernels for this many transforms and exit
+    int benchContacts;          // settle this many crate towers with and without contact reduction and exit
+    bool raycastWheels;         // headless: fleet uses raycast wheels instead of hinge2 wheel bodies
+    bool packAssets;            // write the asset pack and exit
+    int physicsHz;              // fixed physics steps per simulated second
+    bool areaOfInterest;        // only simulate the cells around the camera (see aoi.h)
+    bool ragdollLod;            // collapse distant or sleeping ragdolls to one body
+    bool ccd;                   // sweep fast bodies so a coarse step doesn't tunnel (see ccd.h)
+    int soakMinutes;            // headless soak test for this long (see soak.h)
+    float soakChurn;            // soak: objects / dolls pushed off the plane per simulated second
+    int soakMaxGrowthKB;        // soak: fail if memory grows by more than this
+    int soakMaxDrift;           // soak: fail if step time drifts by more than this percentage
+    const char* captureDir;     // windowed: record the scene into this directory
+    int captureWidth;           // capture resolution
+    int captureHeight;
+    bool capturePng;            // png sequence rather than one raw RGBA file
+    long captureFrames;         // stop after this many captured frames (0 = until closed)
+} AppOptions;
+
+// Fill opts from the command line, returns false (after printing usage) on bad arguments
+bool ParseOptions(AppOptions* opts, int argc, char** argv);
+
+#endif // OPTIONS_H
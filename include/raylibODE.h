@@ -27,21 +27,66 @@
 #include "raylib.h"
 #include "raymath.h"
 
+#include <pthread.h>
 #include <ode/ode.h>
+#include "rng.h"
+#include "trigger.h"
+#include "contactcache.h"
+#include "stepmemory.h"
+#include "aoi.h"
 
 void rayToOdeMat(Matrix* mat, dReal* R);
 void odeToRayMat(const dReal* R, Matrix* matrix);
 
-// Geometry user data - stores collision flag, texture reference, and UV scale
+// Geometry user data - stores collision flag, atlas layer, and UV scale
 typedef struct geomInfo {
     bool collidable;
-    Texture* texture;
+    int layer;                      // AtlasLayer or -1 for the model's default
     float uvScaleU;
     float uvScaleV;
+    struct TriggerVolume* trigger;  // non NULL for sensor geoms
+    unsigned int serial;            // creation order, what deterministic pair ordering sorts on
+
+    // render cache, filled in by drawGeom
+    bool shapeCached;
+    Vector3 scale;                  // model scale for the unit primitive
+    float boundRadius;
+    bool transformCached;
+    bool cachedAsleep;              // transform was built after the body went to sleep
+    unsigned int transformStep;     // PhysicsContext stepCount it was built on
+    Matrix transform;
 } geomInfo;
 
-// Helper to allocate geomInfo with collision flag, optional texture, and UV scale
-geomInfo* CreateGeomInfo(bool collidable, Texture* texture, float uvScaleU, float uvScaleV);
+// Body user data - lets contacts, triggers and queries find
+// the ragdoll or vehicle a body belongs to
+typedef enum {
+    BODY_OWNER_RAGDOLL = 1,
+    BODY_OWNER_VEHICLE
+} BodyOwnerType;
+
+typedef struct BodyOwner {
+    BodyOwnerType type;
+    void* owner;
+} BodyOwner;
+
+// the owning ragdoll / vehicle of a body or NULL
+struct RagDoll;
+struct vehicle;
+struct RagDoll* GetBodyRagdoll(dBodyID body);
+struct vehicle* GetBodyVehicle(dBodyID body);
+
+// the lowest serial of a body's geoms, 0 if none of them has one
+unsigned int GetBodySerial(dBodyID body);
+// an order for bodies that's the same every run: by serial, bodies
+// without one by where they are, the address only if both tie
+int CompareBodyOrder(dBodyID a, dBodyID b);
+
+// Helper to allocate geomInfo with collision flag, atlas layer (-1 for none), and UV scale,
+// the serial is the next of ctx's (0, none, without a ctx)
+struct PhysicsContext;
+geomInfo* CreateGeomInfo(struct PhysicsContext* ctx, bool collidable, int layer, float uvScaleU, float uvScaleV);
+// Frees a geom's CreateGeomInfo data (before destroying the geom)
+void FreeGeomInfo(dGeomID geom);
 
 // Object counts
 #define NUM_OBJ 50
@@ -51,8 +96,11 @@ geomInfo* CreateGeomInfo(bool collidable, Texture* texture, float uvScaleU, floa
 #define PLANE_SIZE 100.0f
 #define PLANE_THICKNESS 1.0f
 
-// Forward declaration
-struct RagDoll;
+// Top of the kill volume below the plane
+#define KILL_VOLUME_TOP 10.0f
+
+// Default fixed physics time step, PhysicsContext slice is the one in use
+#define PHYS_SLICE (1.0f / 240.0f)
 
 // Physics context - holds all physics state
 typedef struct PhysicsContext {
@@ -62,15 +110,52 @@ typedef struct PhysicsContext {
     dBodyID obj[NUM_OBJ];
     struct RagDoll* ragdolls[MAX_RAGDOLLS];
     int ragdollCount;
+    dGeomID ground;
+    dGeomID queryBox;             // spaceless probes for volume queries (force fields)
+    dGeomID querySphere;
+    struct FieldQuery* fieldQuery; // ApplyForceField's hit list, made on first use
+    dGeomID ccdRay;               // spaceless, see ClampFastBodies
+    TriggerSystem triggers;       // sensor volumes and their event queue
+    unsigned int stepCount;       // bumped by every StepPhysics
+    unsigned int geomSerials;     // last serial CreateGeomInfo handed out, a world numbers its own
+    unsigned int respawns;        // ragdolls re-created by ResetFallenObjects
+    int pairCount;                // broadphase pairs in the last step
+    int contactCount;             // contact joints made in the last step
+    ContactCache contacts;        // last step's manifolds, see CollideCached
+    bool reduceContacts;          // trim each pair's contacts to its budget (collision.c)
+    StepMemory stepMemory;        // ODE working memory and contact group peaks
+    float slice;                  // fixed step, PHYS_SLICE unless set otherwise
+    bool ccd;                     // sweep fast bodies before stepping (ccd.c)
+    int ccdClamped;               // bodies slowed down in the last step
+    bool ragdollLod;              // collapse distant / sleeping dolls to proxies
+    Vector3 lodFocus;             // where the dolls are looked at from
+    int ragdollProxies;           // dolls collapsed after the last step
+    AreaOfInterest aoi;           // frozen far away cells (aoi.c)
+    Rng rng;                      // everything random the simulation does
+    bool deterministic;           // sorted pairs and a seeded constraint shuffle (collision.c)
+    struct GeomPair* pairs;       // deterministic: this step's broadphase pairs
+    int pairCapacity;
+    int queuedPairs;
+    pthread_mutex_t* stepLock;    // deterministic: held round the seeded solver when worlds step on several threads
 } PhysicsContext;
 
 // Forward declaration - GraphicsContext is defined in init.h
 struct GraphicsContext;
 
+// call before drawing each frame, sets up culling and LOD selection
+void SetDrawCamera(struct GraphicsContext* ctx, Camera camera);
+
 void drawAllSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx);
+// just the drawGeom part, for drawing more than one space in a flush
+void queueSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx);
+
+// drawGeom only queues the geom, FlushGeomQueue sorts the queue by
+// render state and draws it (drawAllSpaceGeoms does both)
 void drawGeom(dGeomID geom, struct GraphicsContext* ctx);
+void FlushGeomQueue(struct GraphicsContext* ctx);
 
-// Random float in range [min, max]
+// Random float in range [min, max], from rand() so only for things the
+// simulation doesn't depend on (PhysicsContext rng is for those)
 float rndf(float min, float max);
 
 #endif // RAYLIBODE_H
@@ -27,8 +27,18 @@
 #include "raylib.h"
 
 #include <ode/ode.h>
+#include "raylibODE.h"
 
 
+// A part's pose relative to the doll's proxy body (see CollapseRagdoll)
+typedef struct RagdollPart {
+    dVector3 position;          // body origin in the proxy's frame
+    dMatrix3 rotation;          // body rotation in the proxy's frame
+    dVector3 geomPosition;      // the geom's own offset on the part body
+    dMatrix3 geomRotation;
+    bool geomOffset;            // false if the geom sits at the body origin
+} RagdollPart;
+
 // Rag doll structure - generic enough for neural network muscle control
 // Uses motors on joints for future neural network control
 typedef struct RagDoll {
@@ -36,9 +46,28 @@ typedef struct RagDoll {
     dGeomID *geoms;            // Array of geometries
     dJointID *joints;           // Array of joints connecting bodies
     dJointID *motors;           // Array of motor joints for muscle control
+    float *masses;              // Per body mass, doesn't change after creation
     int bodyCount;              // Number of bodies
     int jointCount;             // Number of joints
     int motorCount;             // Number of motors
+
+    // Aggregate properties - totalMass is set on creation the rest
+    // are refreshed once per step by UpdateRagdollAggregates
+    float totalMass;
+    Vector3 centerOfMass;
+    float boundRadius;          // bounding sphere around centerOfMass
+    bool enabled;               // true if any part is awake
+
+    BodyOwner owner;            // user data for every body
+
+    // physics LOD - while collapsed every geom rides on one rigid proxy
+    // body, the parts and joints are disabled and just follow it
+    dBodyID proxy;              // NULL when fully articulated
+    RagdollPart* parts;         // per body pose in the proxy, bodyCount of them
+    bool lodHit;                // the proxy was struck this step, promote it
+    int lodHold;                // steps before a promoted doll may collapse again
+
+    struct RagdollRest* rest;   // the spawn pose, parts are unrotated in it
 } RagDoll;
 
 // Predefined rag doll body parts for easy access
@@ -56,16 +85,59 @@ typedef enum {
     RAGDOLL_BODY_COUNT         // Total count
 } RagdollBodyPart;
 
+// neck, shoulders, elbows, hips, knees
+#define RAGDOLL_JOINT_COUNT 9
+
+// The doll as it was made, relative to its torso, so the joints can be
+// rebuilt in another world with the same zero angles (MoveRagdoll)
+typedef struct RagdollJointRest {
+    dVector3 anchor;
+    dVector3 axis1;
+    dVector3 axis2;             // universal joints only
+    float stops[4];             // lo, hi, lo2, hi2
+} RagdollJointRest;
+
+typedef struct RagdollRest {
+    dVector3 position[RAGDOLL_BODY_COUNT];
+    RagdollJointRest joints[RAGDOLL_JOINT_COUNT];
+} RagdollRest;
+
 
 // Forward declaration - GraphicsContext is defined in init.h
 struct GraphicsContext;
 
 // Rag doll functions - generic for neural network muscle control
-RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct GraphicsContext* ctx);
+RagDoll* CreateRagdoll(PhysicsContext *ctx, Vector3 position);
 void UpdateRagdollMotors(RagDoll *ragdoll, float *motorForces);
 void DrawRagdoll(RagDoll *ragdoll, struct GraphicsContext* ctx);
 void FreeRagdoll(RagDoll *ragdoll, PhysicsContext *ctx);
 
+// Refresh the cached aggregates, cheap when the whole doll is asleep
+void UpdateRagdollAggregates(RagDoll *ragdoll);
+// Wake every part of the doll
+void EnableRagdoll(RagDoll *ragdoll);
+
+// Physics LOD. A collapsed doll is a single body with the aggregate
+// mass and inertia holding its pose frozen, promoting it puts the
+// articulation back in that pose with the proxy's motion carried over
+// to every part. UpdateRagdollLod does both, collapsing dolls that are
+// asleep or further than RAGDOLL_LOD_FAR from ctx->lodFocus, and
+// promoting awake proxies inside RAGDOLL_LOD_NEAR or any that were hit
+#define RAGDOLL_LOD_NEAR 20.0f
+#define RAGDOLL_LOD_FAR 30.0f
+#define RAGDOLL_LOD_HOLD 240        // steps a promoted doll stays articulated
+#define RAGDOLL_LOD_HIT_SPEED 1.0f  // closing speed that counts as a hit
+void CollapseRagdoll(RagDoll *ragdoll, PhysicsContext *ctx);
+void PromoteRagdoll(RagDoll *ragdoll, PhysicsContext *ctx);
+void UpdateRagdollLod(PhysicsContext *ctx);
+// nearCallback tells the dolls about contacts between two bodies
+void NoteRagdollContact(dBodyID b1, dBodyID b2);
+
+// Rebuild the doll's bodies and joints in to's world and move its geoms
+// to to's space, pose and motion unchanged. A collapsed doll is promoted
+// first. The caller moves it between the contexts' ragdoll lists
+void MoveRagdoll(RagDoll *ragdoll, PhysicsContext *from, PhysicsContext *to);
+
 // Ragdoll spawn configuration
 #define RAGDOLL_SPAWN_CENTER_X 0.0f
 #define RAGDOLL_SPAWN_CENTER_Z 0.0f
@@ -74,6 +146,6 @@ void FreeRagdoll(RagDoll *ragdoll, PhysicsContext *ctx);
 #define RAGDOLL_SPAWN_MAX_Y 1.6f
 
 // Get a random spawn position within the defined ragdoll spawn volume
-Vector3 GetRagdollSpawnPosition(void);
+Vector3 GetRagdollSpawnPosition(Rng* rng);
 
 #endif // RAYLIBODERAGDOLL_H
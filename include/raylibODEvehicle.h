@@ -27,21 +27,75 @@
 #include "raylib.h"
 
 #include <ode/ode.h>
+#include "raylibODE.h"
 
+typedef enum {
+    VEHICLE_HINGE2 = 0,         // wheel bodies on hinge2 joints plus counter weight
+    VEHICLE_RAYCAST             // chassis only, each wheel is a ray with an analytic spring
+} VehicleModel;
+
+// Everything about a vehicle's build, DefaultVehicleDesc is the original car
+typedef struct VehicleDesc {
+    VehicleModel model;
+    Vector3 chassisSize;        // box lengths, x is forward
+    float chassisMass;
+    float wheelRadius;
+    float wheelWidth;
+    float wheelMass;
+    float axleOffset;           // front / rear axle distance from the chassis centre (x)
+    float trackOffset;          // left / right wheel distance from the chassis centre (z)
+    float wheelDrop;            // wheel centres below the chassis centre
+    float counterWeightDrop;    // anti roll weight below the chassis centre
+    float motorForce;           // hinge2 drive max force
+    float steerForce;           // hinge2 steering max force
+    float steerLimit;           // radians either way
+
+    // raycast model only, the rest length is wheelDrop
+    float springRate;           // N/m per wheel
+    float damping;              // N/(m/s) per wheel
+    float tireGrip;             // friction coefficient for the tire forces
+    float rollInfluence;        // 0 applies tire forces at the contact, 1 at the chassis centre
+} VehicleDesc;
 
 // 0 chassis / 1-4 wheel / 5 anti roll counter weight
+// raycast vehicles only have the chassis body and joints, geoms 1-4 are the
+// (spaceless) wheel rays and 5 is unused
 typedef struct vehicle {
     dBodyID bodies[6];
     dGeomID geoms[6];
     dJointID joints[6];
+    dSpaceID space;             // what the wheel rays are cast against
+    dGeomID cab;                // small box on top of the chassis
+    VehicleDesc desc;
+    Vector3 spawn;              // where ResetVehicle puts it back
+    geomInfo noCollide;         // user data for the counter weight
+    BodyOwner owner;            // user data for every body
+    float lastAccel;            // last drive value sent to the motors
+    float steerAngle;           // raycast: current front wheel angle
+    float slice;                // raycast: the physics step it's updated before
+    float compression[4];       // raycast: per wheel suspension travel (0 = airborne)
 } vehicle;
 
+// per vehicle input for updateVehicles
+typedef struct VehicleControl {
+    float accel;
+    float steer;
+} VehicleControl;
 
 // Vehicle functions
-vehicle* CreateVehicle(dSpaceID space, dWorldID world);
+VehicleDesc DefaultVehicleDesc(void);
+// NULL if the vehicle couldn't be allocated
+vehicle* CreateVehicle(dSpaceID space, dWorldID world, Vector3 position, const VehicleDesc* desc);
+// NB raycast vehicles apply forces, so must be updated before every world step
 void updateVehicle(vehicle *car, float accel, float maxAccelForce,
                     float steer, float steerFactor);
+// one call for a whole fleet, motor params are only touched when the input changes
+void updateVehicles(vehicle **cars, const VehicleControl *controls, int count,
+                    float maxAccelForce, float steerFactor);
 void unflipVehicle(vehicle *car);
+// put the vehicle back upright and stationary at its spawn point
+void ResetVehicle(vehicle *car);
+void FreeVehicle(vehicle *car, PhysicsContext *ctx);
 
 
 #endif // RAYLIBODEVEHICLE_H
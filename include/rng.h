@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Philox 4x32-10 (Salmon et al, "Parallel random numbers: as easy as
+// 1, 2, 3"), a counter based generator - each block of four numbers is
+// just a hash of (counter, stream) under the seed, so there's no hidden
+// global state to race on and two worlds with different streams never
+// share a sequence. Every PhysicsContext has its own, anything the
+// simulation depends on (spawns, respawns, jitter) draws from it, rndf
+// is left for the purely cosmetic.
+typedef struct Rng {
+    uint32_t key[2];            // the seed
+    uint32_t counter[4];        // block index (64 bit) then the stream
+    uint32_t block[4];
+    int used;                   // of block, 4 when it's spent
+} Rng;
+
+void SeedRng(Rng* rng, unsigned long seed, uint32_t stream);
+uint32_t RngNext(Rng* rng);
+// float in [min, max)
+float RngFloat(Rng* rng, float min, float max);
+// int in [0, n)
+int RngInt(Rng* rng, int n);
+
+#endif // RNG_H
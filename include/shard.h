@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <pthread.h>
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "options.h"
+
+// Spatial shards - the plane is cut into slabs along x, each with its
+// own world, space and contact group (a whole PhysicsContext), stepped
+// in parallel by the workers (shard i on worker i % workers). Only the
+// collision and solver run side by side, only with the deterministic flag
+// do the solvers take turns as each reseeds ODE's global dRand. Objects and ragdolls belong to the shard
+// their centre is in and are rebuilt in the neighbour's world once they are more than
+// SHARD_HYSTERESIS past the edge. Geoms within SHARD_GHOST_MARGIN of an
+// edge get a kinematic ghost in the neighbour so things on either side
+// still collide, each side pushes on the other's ghost and the ghosts
+// follow the real thing every step. The ground and kill volume are in
+// every shard. Shard i's rng is the seed's stream i, so with the
+// contexts' deterministic flag set a run only depends on the seed and
+// the shard count, never on how many workers there are.
+#define SHARD_MAX 8
+#define SHARD_HYSTERESIS 0.5f
+#define SHARD_GHOST_MARGIN 1.5f
+
+typedef struct Ghost {
+    dGeomID source;             // the real geom in the neighbouring shard
+    int from;                   // and that shard
+    dBodyID body;               // kinematic, in this shard's world
+    dGeomID geom;               // same shape as the source, no offset
+    unsigned int stamp;         // last ShardSet stamp it was wanted on
+} Ghost;
+
+struct ShardSet;
+
+typedef struct Shard {
+    PhysicsContext* ctx;
+    dSpaceID space;
+    float minX, maxX;           // the outer shards are open ended
+    Ghost* ghosts;
+    int ghostCount;
+    int ghostCapacity;
+    double stepTime;            // seconds spent in StepPhysics
+} Shard;
+
+typedef struct ShardWorker {
+    struct ShardSet* set;
+    int index;
+    pthread_t thread;
+    bool running;
+} ShardWorker;
+
+typedef struct ShardSet {
+    Shard shards[SHARD_MAX];
+    int count;
+    ShardWorker workers[SHARD_MAX];
+    int workerCount;
+    pthread_mutex_t stepLock;   // every shard's stepLock when deterministic, ODE's dRand is shared
+    float slice;
+    unsigned int stamp;
+    long migrations;
+
+    // a step is handed out by bumping generation, the last worker
+    // to finish it signals finished
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    unsigned int generation;
+    int pending;
+    bool stopping;
+} ShardSet;
+
+// The usual scene, made from seed, split over count shards (2..SHARD_MAX)
+// and stepped on workers threads (0 or more than count for one each),
+// returns false if the shards or their threads couldn't all be made
+bool InitShards(ShardSet* set, int count, int workers, float slice, unsigned long seed);
+// migrate, refresh the ghosts, step every shard at once, respawn
+void StepShards(ShardSet* set);
+void FreeShards(ShardSet* set);
+
+// --headless --shards N
+int RunShards(const AppOptions* opts);
+
+#endif // SHARD_H
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SHMSERVER_H
+#define SHMSERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Local shared memory control channel for out of process controllers
+//
+// The segment starts with a ShmControlHeader followed by two float arrays,
+// observations (written by the sim) and actions (written by the client),
+// their offsets and per ragdoll sizes are in the header so clients don't
+// need to know anything else about the sim.
+//
+// Step handshake, both sequence counters are futex words:
+//   sim    - writes observations, bumps obsSeq, wakes obsSeq
+//   client - waits for obsSeq to change, writes actions,
+//            sets actSeq = obsSeq, wakes actSeq
+//   sim    - waits for actSeq == obsSeq, applies actions, steps the world
+//
+// The client puts its pid in clientPid once it's attached, the sim gives
+// up on the session if that process goes away while it's waiting.
+//
+// This header is deliberately free of raylib/ODE so clients can include it.
+
+#define SHM_CONTROL_MAGIC   0x4c4f4452u     // "RDOL"
+#define SHM_CONTROL_VERSION 2
+
+// per body observation pos(3) quaternion(4) linear vel(3) angular vel(3)
+#define SHM_OBS_PER_BODY    13
+
+typedef enum {
+    SHM_STATE_RUNNING = 0,
+    SHM_STATE_SHUTDOWN          // either side may set this to end the session
+} ShmControlState;
+
+typedef struct ShmControlHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ragdollCount;
+    uint32_t bodiesPerRagdoll;
+    uint32_t torsoBody;         // index of the torso among a ragdoll's bodies
+    uint32_t obsPerRagdoll;     // floats
+    uint32_t actPerRagdoll;     // floats, layout as UpdateRagdollMotors
+    uint32_t obsOffset;         // bytes from the start of the segment
+    uint32_t actOffset;         // bytes from the start of the segment
+    uint32_t totalSize;         // bytes
+    float stepSize;             // seconds of sim time per handshake
+    uint32_t state;             // ShmControlState
+    uint32_t obsSeq;            // futex word, bumped by the sim
+    uint32_t actSeq;            // futex word, set by the client
+    uint32_t clientPid;         // set by the client, 0 until one attaches
+    uint64_t step;              // sim step the current observations belong to
+} ShmControlHeader;
+
+#define SHM_OBSERVATIONS(hdr) ((float*)((char*)(hdr) + (hdr)->obsOffset))
+#define SHM_ACTIONS(hdr) ((float*)((char*)(hdr) + (hdr)->actOffset))
+
+// Forward declaration - PhysicsContext is defined in raylibODE.h
+struct PhysicsContext;
+
+typedef struct ShmServer {
+    char name[64];
+    int fd;
+    ShmControlHeader* hdr;
+} ShmServer;
+
+// create (or replace) the named segment sized for ctx's ragdolls
+bool ShmServerOpen(ShmServer* srv, const char* name, struct PhysicsContext* ctx, float stepSize);
+// publish observations and wait for the client to answer with actions
+// returns false if the client shut the session down or went away
+bool ShmServerExchange(ShmServer* srv, struct PhysicsContext* ctx, uint64_t step);
+void ShmServerClose(ShmServer* srv);
+
+#endif // SHMSERVER_H
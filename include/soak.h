@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SOAK_H
+#define SOAK_H
+
+#include "options.h"
+
+// Headless soak test - the scene runs flat out for opts->soakMinutes of
+// wall time while objects and dolls are pushed off the plane at
+// opts->soakChurn a (simulated) second, so the kill volume keeps
+// respawning them. Every SOAK_SAMPLE_SECONDS the resident set, tracked
+// live bytes, allocation count and step time are logged and compared
+// with the first samples after warm up. Returns 0, or 2 if memory grew
+// or step time drifted past the thresholds SOAK_STRIKES samples running.
+#define SOAK_SAMPLE_SECONDS 30
+#define SOAK_WARMUP_SAMPLES 2       // the baseline is the last of these
+#define SOAK_STRIKES 3
+
+int RunSoak(const AppOptions* opts);
+
+#endif // SOAK_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef STEPMEMORY_H
+#define STEPMEMORY_H
+
+#include <stddef.h>
+#include <ode/ode.h>
+
+// ODE's per step working memory and the contact joint group both grow
+// on demand, so a step that needs more than any before it mallocs in
+// the middle of a frame. For the first STEP_MEMORY_WARMUP steps the
+// peaks are recorded, after that both are reserved with headroom and
+// steady state steps shouldn't allocate at all.
+#define STEP_MEMORY_WARMUP 240          // a second of simulation
+#define STEP_MEMORY_HEADROOM 1.5f
+#define STEP_MEMORY_MIN_CONTACTS 256    // contact joints reserved at the least
+
+typedef struct StepMemory {
+    size_t blockSize;           // ODE's working memory as it stands
+    size_t peakBlock;           // the most ODE has asked for
+    int allocs;                 // working memory (re)allocations
+    int lateAllocs;             // of those, after the reservation
+    int peakContacts;           // contact joints in one step
+    int reservedContacts;       // the contact group holds this many without growing
+    unsigned int warmup;        // steps left before reserving
+    bool growing;               // the next allocation is the reservation taking effect
+} StepMemory;
+
+// Hooks ODE's step memory for world, do this before the first step
+void InitStepMemory(StepMemory* mem, dWorldID world);
+
+// Either side of dWorldQuickStep, contacts is this step's joint count.
+// The end of the warm up reserves the working memory and grows group
+// (which has to be empty then).
+void StepMemoryBegin(StepMemory* mem);
+void StepMemoryEnd(StepMemory* mem, dWorldID world, dJointGroupID group, int contacts);
+
+#endif // STEPMEMORY_H
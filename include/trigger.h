@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+
+// Sensor volumes - geoms that never make contacts, instead the collision
+// callback records which bodies overlap them and the differences between
+// steps are queued as enter / exit events for the game loop to drain
+
+// trigger ids used by the demo
+#define TRIGGER_KILL 0          // below the ground plane, anything entering is respawned
+
+#define MAX_TRIGGERS 16
+
+typedef enum {
+    TRIGGER_ENTER = 0,
+    TRIGGER_EXIT
+} TriggerEventType;
+
+typedef struct TriggerEvent {
+    TriggerEventType type;
+    int triggerId;
+    dBodyID body;               // NULL if the body was destroyed before the event was read
+} TriggerEvent;
+
+typedef struct TriggerVolume {
+    int id;
+    dGeomID geom;
+    dBodyID* inside;            // sorted, as of the end of the last step
+    int insideCount, insideCap;
+    dBodyID* touching;          // gathered while the space is collided
+    int touchingCount, touchingCap;
+} TriggerVolume;
+
+typedef struct TriggerSystem {
+    TriggerVolume* volumes[MAX_TRIGGERS];
+    int count;
+    TriggerEvent* events;
+    int eventCount, eventCap, eventRead;
+} TriggerSystem;
+
+// Add an axis aligned box sensor to space
+TriggerVolume* CreateTriggerBox(TriggerSystem* sys, dSpaceID space, int id, Vector3 position, Vector3 size);
+
+// Bracket every dSpaceCollide with these
+void TriggerBeginStep(TriggerSystem* sys);
+void TriggerEndStep(TriggerSystem* sys);
+
+// Called by the near callback, true if either geom is a trigger (no contacts wanted)
+bool TriggerCollide(dGeomID o1, dGeomID o2);
+
+// Next queued event, false when the queue is empty
+bool PollTriggerEvent(TriggerSystem* sys, TriggerEvent* ev);
+
+// Must be called before destroying a body that might be inside a trigger
+void TriggerForgetBody(TriggerSystem* sys, dBodyID body);
+
+void FreeTriggers(TriggerSystem* sys);
+
+#endif // TRIGGER_H
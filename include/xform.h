@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef XFORM_H
+#define XFORM_H
+
+#include "raylib.h"
+
+// Model matrices straight from ODE transforms - the result is
+// translate * rotate * scale but built directly rather than through
+// two full 4x4 multiplies. Positions are ODE dVector3 (4 floats each),
+// rotations ODE dMatrix3 (3 rows of 4), both single precision.
+void BuildModelMatrices(const float* positions, const float* rotations,
+                        const Vector3* scales, Matrix* out, int count);
+
+// The scalar version, used where SSE isn't available (and by the bench)
+void BuildModelMatricesScalar(const float* positions, const float* rotations,
+                              const Vector3* scales, Matrix* out, int count);
+
+#endif // XFORM_H
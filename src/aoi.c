@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "raylibODEvehicle.h"
+#include "memtrack.h"
+#include "aoi.h"
+
+bool InitAreaOfInterest(AreaOfInterest* aoi)
+{
+    *aoi = (AreaOfInterest){ 0 };
+    // only ever added to and removed from, a simple space does nothing else
+    MemTag tag = MemSetTag(MEM_SPACES);
+    aoi->frozen = dSimpleSpaceCreate(NULL);
+    MemSetTag(tag);
+    dSpaceSetCleanup(aoi->frozen, 0);
+    return aoi->frozen != NULL;
+}
+
+void FreeAreaOfInterest(AreaOfInterest* aoi)
+{
+    if (aoi->frozen) dSpaceDestroy(aoi->frozen);
+    MemFree(aoi->bodies);
+    *aoi = (AreaOfInterest){ 0 };
+}
+
+// where a body counts as being, a doll or vehicle's parts all use
+// the same place so they're never split up
+static void bodyAnchor(dBodyID b, float* x, float* z)
+{
+    RagDoll* rd = GetBodyRagdoll(b);
+    vehicle* car = rd ? NULL : GetBodyVehicle(b);
+    if (rd) {
+        *x = rd->centerOfMass.x;
+        *z = rd->centerOfMass.z;
+        return;
+    }
+    const dReal* p = dBodyGetPosition(car ? car->bodies[0] : b);
+    *x = p[0];
+    *z = p[2];
+}
+
+// cells between the body and the nearest point of interest
+static int cellDistance(const AreaOfInterest* aoi, dBodyID b)
+{
+    float x, z;
+    bodyAnchor(b, &x, &z);
+    const int cx = (int)floorf(x / AOI_CELL_SIZE), cz = (int)floorf(z / AOI_CELL_SIZE);
+    if (!aoi->pointCount) return 0;
+    int nearest = 1 << 30;
+    for (int i = 0; i < aoi->pointCount; i++) {
+        const int dx = abs(cx - (int)floorf(aoi->points[i].x / AOI_CELL_SIZE));
+        const int dz = abs(cz - (int)floorf(aoi->points[i].z / AOI_CELL_SIZE));
+        const int d = dx > dz ? dx : dz;
+        if (d < nearest) nearest = d;
+    }
+    return nearest;
+}
+
+static void moveGeoms(dBodyID b, dSpaceID from, dSpaceID to)
+{
+    for (dGeomID g = dBodyGetFirstGeom(b); g; g = dBodyGetNextGeom(g)) {
+        if (dGeomGetSpace(g) != from) continue;
+        dSpaceRemove(from, g);
+        dSpaceAdd(to, g);
+    }
+}
+
+// a body is looked at once, at its first geom in the space (raycast
+// wheels are on the chassis but in no space)
+static bool firstInSpace(dGeomID g, dBodyID b, dSpaceID space)
+{
+    for (dGeomID o = dBodyGetFirstGeom(b); o != g; o = dBodyGetNextGeom(o)) {
+        if (dGeomGetSpace(o) == space) return false;
+    }
+    return true;
+}
+
+// only noted, the geoms are moved once the space isn't being walked
+static bool noteFrozen(AreaOfInterest* aoi, dBodyID b)
+{
+    if (aoi->frozenCount == aoi->capacity) {
+        int capacity = aoi->capacity ? aoi->capacity * 2 : 64;
+        FrozenBody* bodies = MemRealloc(MEM_SPACES, aoi->bodies, capacity * sizeof(FrozenBody));
+        if (!bodies) return false;  // stays live
+        aoi->bodies = bodies;
+        aoi->capacity = capacity;
+    }
+    aoi->bodies[aoi->frozenCount++] = (FrozenBody){ b, dBodyIsEnabled(b) };
+    return true;
+}
+
+static void thaw(AreaOfInterest* aoi, int i, dSpaceID space)
+{
+    FrozenBody* f = &aoi->bodies[i];
+    moveGeoms(f->body, aoi->frozen, space);
+    // anything added while it was frozen isn't owed
+    dBodySetForce(f->body, 0, 0, 0);
+    dBodySetTorque(f->body, 0, 0, 0);
+    if (f->enabled) dBodyEnable(f->body);
+    aoi->bodies[i] = aoi->bodies[--aoi->frozenCount];
+}
+
+void UpdateAreaOfInterest(PhysicsContext* ctx)
+{
+    AreaOfInterest* aoi = &ctx->aoi;
+    if (!aoi->enabled || !aoi->frozen || ctx->stepCount % AOI_UPDATE_STEPS) return;
+    dSpaceID space = *ctx->space;
+
+    // a cell of slack between thawing and freezing again
+    for (int i = aoi->frozenCount - 1; i >= 0; i--) {
+        if (cellDistance(aoi, aoi->bodies[i].body) <= AOI_RADIUS) thaw(aoi, i, space);
+    }
+
+    int active = 0;
+    const int first = aoi->frozenCount;
+    const int ng = dSpaceGetNumGeoms(space);
+    for (int i = 0; i < ng; i++) {
+        dGeomID g = dSpaceGetGeom(space, i);
+        dBodyID b = dGeomGetBody(g);
+        if (!b || !firstInSpace(g, b, space)) continue;
+        if (cellDistance(aoi, b) <= AOI_RADIUS + 1 || !noteFrozen(aoi, b)) active++;
+    }
+    for (int i = first; i < aoi->frozenCount; i++) {
+        dBodyDisable(aoi->bodies[i].body);
+        moveGeoms(aoi->bodies[i].body, space, aoi->frozen);
+    }
+    aoi->activeCount = active;
+}
+
+void ThawAll(PhysicsContext* ctx)
+{
+    AreaOfInterest* aoi = &ctx->aoi;
+    while (aoi->frozenCount) thaw(aoi, aoi->frozenCount - 1, *ctx->space);
+}
+
+void ThawBody(PhysicsContext* ctx, dBodyID body)
+{
+    AreaOfInterest* aoi = &ctx->aoi;
+    for (int i = aoi->frozenCount - 1; i >= 0; i--) {
+        if (aoi->bodies[i].body == body) {
+            thaw(aoi, i, *ctx->space);
+            return;
+        }
+    }
+}
+
+float AreaOfInterestActiveFraction(const AreaOfInterest* aoi)
+{
+    const int total = aoi->activeCount + aoi->frozenCount;
+    return total ? (float)aoi->activeCount / total : 1;
+}
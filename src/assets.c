@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "raylib.h"
+#include "atlas.h"
+#include "assets.h"
+#include "memtrack.h"
+
+#define ASSET_CYLINDER_OBJ "data/cylinder.obj"
+#define ASSET_LIGHT_VS "data/simpleLight.vs"
+#define ASSET_LIGHT_FS "data/simpleLight.fs"
+
+//--------------------------------------------------------------------------------------
+// .obj - just enough for the Blender exports in data/ (v vt vn f, polygons
+// fanned into triangles), no GL needed unlike LoadModel
+//--------------------------------------------------------------------------------------
+
+typedef struct FloatList {
+    float* data;
+    int count;
+    int capacity;
+} FloatList;
+
+static void pushFloats(FloatList* l, const float* v, int n)
+{
+    if (l->count + n > l->capacity) {
+        l->capacity = (l->count + n) * 2;
+        l->data = RL_REALLOC(l->data, l->capacity * sizeof(float));
+    }
+    memcpy(l->data + l->count, v, n * sizeof(float));
+    l->count += n;
+}
+
+// obj indices are 1 based, negative counts back from the end
+static int objIndex(int i, int count)
+{
+    return (i < 0) ? count + i : i - 1;
+}
+
+static bool parseObj(const char* text, Mesh* mesh)
+{
+    FloatList pos = { 0 }, uv = { 0 }, nrm = { 0 };
+    FloatList outPos = { 0 }, outUv = { 0 }, outNrm = { 0 };
+
+    for (const char* line = text; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+        float v[3] = { 0 };
+        if (strncmp(line, "v ", 2) == 0) {
+            sscanf(line + 2, "%f %f %f", &v[0], &v[1], &v[2]);
+            pushFloats(&pos, v, 3);
+        } else if (strncmp(line, "vt ", 3) == 0) {
+            sscanf(line + 3, "%f %f", &v[0], &v[1]);
+            v[1] = 1.0f - v[1];     // as raylib's loader does
+            pushFloats(&uv, v, 2);
+        } else if (strncmp(line, "vn ", 3) == 0) {
+            sscanf(line + 3, "%f %f %f", &v[0], &v[1], &v[2]);
+            pushFloats(&nrm, v, 3);
+        } else if (strncmp(line, "f ", 2) == 0) {
+            int corners[32][3];
+            int n = 0;
+            bool bad = false;
+            const char* p = line + 2;
+            for (;;) {
+                int vi = 0, ti = 0, ni = 0, used = 0;
+                while (*p == ' ' || *p == '\t') p++;
+                if (*p == '\0' || *p == '\n' || *p == '\r') break;
+                if (n == 32 || !(sscanf(p, "%i/%i/%i%n", &vi, &ti, &ni, &used) == 3 ||
+                                 (ti = 0, sscanf(p, "%i//%i%n", &vi, &ni, &used) == 2))) {
+                    bad = true;
+                    break;
+                }
+                int* c = corners[n++];
+                c[0] = objIndex(vi, pos.count / 3);
+                c[1] = ti ? objIndex(ti, uv.count / 2) : -1;
+                c[2] = objIndex(ni, nrm.count / 3);
+                // 0 or a relative index reaching back past the start
+                // comes out negative
+                if (c[0] < 0 || c[0] * 3 >= pos.count || c[2] < 0 || c[2] * 3 >= nrm.count ||
+                    (ti && (c[1] < 0 || c[1] * 2 >= uv.count))) {
+                    bad = true;
+                    break;
+                }
+                p += used;
+            }
+            // the whole face goes, half of one would shift every vertex after it
+            if (bad) continue;
+
+            // fan the polygon into triangles
+            for (int t = 1; t + 1 < n; t++) {
+                const int tri[3] = { 0, t, t + 1 };
+                for (int k = 0; k < 3; k++) {
+                    const int* c = corners[tri[k]];
+                    const float noUv[2] = { 0, 0 };
+                    pushFloats(&outPos, &pos.data[c[0] * 3], 3);
+                    pushFloats(&outUv, c[1] >= 0 ? &uv.data[c[1] * 2] : noUv, 2);
+                    pushFloats(&outNrm, &nrm.data[c[2] * 3], 3);
+                }
+            }
+        }
+    }
+
+    RL_FREE(pos.data);
+    RL_FREE(uv.data);
+    RL_FREE(nrm.data);
+
+    *mesh = (Mesh){ 0 };
+    mesh->vertexCount = outPos.count / 3;
+    mesh->triangleCount = mesh->vertexCount / 3;
+    mesh->vertices = outPos.data;
+    mesh->texcoords = outUv.data;
+    mesh->normals = outNrm.data;
+    return mesh->vertexCount > 0;
+}
+
+static bool loadObj(const char* fileName, Mesh* mesh)
+{
+    char* text = LoadFileText(fileName);
+    if (!text) return false;
+    bool ok = parseObj(text, mesh);
+    UnloadFileText(text);
+    return ok;
+}
+
+//--------------------------------------------------------------------------------------
+// worker threads
+//--------------------------------------------------------------------------------------
+
+typedef struct LoadJobs {
+    AssetSet* set;
+    Image layers[ATLAS_LAYER_COUNT];
+    bool meshOk;
+    const AssetEntry* meshEntry;    // pack path only
+    int next;                       // next job, taken with an atomic add
+    int count;
+} LoadJobs;
+
+// from the sources: jobs are the atlas layers then the mesh
+static void* sourceWorker(void* data)
+{
+    LoadJobs* jobs = (LoadJobs*)data;
+    int j;
+    while ((j = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED)) < jobs->count) {
+        if (j < ATLAS_LAYER_COUNT) {
+            jobs->layers[j] = LoadAtlasLayer(j);
+        } else {
+            jobs->meshOk = loadObj(ASSET_CYLINDER_OBJ, &jobs->set->cylinder);
+        }
+    }
+    return NULL;
+}
+
+// from the pack: the mesh arrays are copied out (raylib frees them
+// with the model), the atlas pages are faulted in a slice per job
+#define ATLAS_TOUCH_JOBS 8
+
+static void* packWorker(void* data)
+{
+    LoadJobs* jobs = (LoadJobs*)data;
+    AssetSet* set = jobs->set;
+    int j;
+    while ((j = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED)) < jobs->count) {
+        if (j < ATLAS_TOUCH_JOBS) {
+            size_t size = (size_t)set->atlas.width * set->atlas.height * 4;
+            size_t from = size / ATLAS_TOUCH_JOBS * j;
+            size_t to = (j == ATLAS_TOUCH_JOBS - 1) ? size : from + size / ATLAS_TOUCH_JOBS;
+            volatile const unsigned char* px = (const unsigned char*)set->atlas.data;
+            unsigned int sum = 0;
+            for (size_t o = from; o < to; o += 4096) sum += px[o];
+            (void)sum;
+        } else {
+            const AssetEntry* e = jobs->meshEntry;
+            const float* src = (const float*)((const char*)set->map + e->offset);
+            int n = e->width;
+            Mesh* m = &set->cylinder;
+            *m = (Mesh){ 0 };
+            m->vertexCount = n;
+            m->triangleCount = n / 3;
+            m->vertices = RL_MALLOC(n * 3 * sizeof(float));
+            m->texcoords = RL_MALLOC(n * 2 * sizeof(float));
+            m->normals = RL_MALLOC(n * 3 * sizeof(float));
+            memcpy(m->vertices, src, n * 3 * sizeof(float));
+            memcpy(m->texcoords, src + n * 3, n * 2 * sizeof(float));
+            memcpy(m->normals, src + n * 5, n * 3 * sizeof(float));
+            jobs->meshOk = true;
+        }
+    }
+    return NULL;
+}
+
+static void runJobs(LoadJobs* jobs, void* (*worker)(void*))
+{
+    pthread_t threads[8];
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int n = (cpus < 1) ? 1 : (cpus > 8 ? 8 : (int)cpus);
+    if (n > jobs->count) n = jobs->count;
+
+    int started = 0;
+    for (int i = 0; i < n; i++) {
+        if (pthread_create(&threads[i], NULL, worker, jobs) == 0) started++;
+    }
+    worker(jobs);   // help out, and covers thread creation failing
+    for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+}
+
+//--------------------------------------------------------------------------------------
+// pack
+//--------------------------------------------------------------------------------------
+
+static const AssetEntry* findEntry(const AssetSet* set, const char* name, AssetType type)
+{
+    const AssetPackHeader* h = (const AssetPackHeader*)set->map;
+    const AssetEntry* entries = (const AssetEntry*)(h + 1);
+    for (uint32_t i = 0; i < h->count; i++) {
+        const AssetEntry* e = &entries[i];
+        if (e->type != (uint32_t)type || strncmp(e->name, name, sizeof(e->name)) != 0) continue;
+        if (e->offset + e->size > set->mapSize) return NULL;
+        return e;
+    }
+    return NULL;
+}
+
+// a source edited since the pack was written wins, missing sources
+// (a pack shipped on its own) don't count
+static bool packIsStale(time_t packTime)
+{
+    const char* sources[3 + ATLAS_LAYER_COUNT] = { ASSET_CYLINDER_OBJ, ASSET_LIGHT_VS, ASSET_LIGHT_FS };
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) sources[3 + i] = AtlasLayerFile(i);
+    for (int i = 0; i < 3 + ATLAS_LAYER_COUNT; i++) {
+        struct stat st;
+        if (stat(sources[i], &st) == 0 && st.st_mtime > packTime) {
+            printf("assets: %s is newer than %s, loading the sources (--pack-assets to rebuild)\n",
+                   sources[i], ASSET_PACK_FILE);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool mapPack(AssetSet* set)
+{
+    int fd = open(ASSET_PACK_FILE, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AssetPackHeader) || packIsStale(st.st_mtime)) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const AssetPackHeader* h = (const AssetPackHeader*)map;
+    if (h->magic != ASSET_PACK_MAGIC || h->version != ASSET_PACK_VERSION ||
+        sizeof(AssetPackHeader) + h->count * sizeof(AssetEntry) > (size_t)st.st_size) {
+        printf("assets: %s is stale or damaged, ignoring it\n", ASSET_PACK_FILE);
+        munmap(map, st.st_size);
+        return false;
+    }
+    set->map = map;
+    set->mapSize = st.st_size;
+    return true;
+}
+
+// text is handed straight to raylib, it has to end inside its entry
+static bool terminated(const AssetSet* set, const AssetEntry* e)
+{
+    return e->size > 0 && ((const char*)set->map)[e->offset + e->size - 1] == '\0';
+}
+
+static bool loadFromPack(AssetSet* set)
+{
+    const AssetEntry* atlas = findEntry(set, "atlas", ASSET_IMAGE);
+    const AssetEntry* mesh = findEntry(set, ASSET_CYLINDER_OBJ, ASSET_MESH);
+    const AssetEntry* vs = findEntry(set, ASSET_LIGHT_VS, ASSET_TEXT);
+    const AssetEntry* fs = findEntry(set, ASSET_LIGHT_FS, ASSET_TEXT);
+    if (!atlas || !mesh || !vs || !fs || !terminated(set, vs) || !terminated(set, fs) ||
+        atlas->size != (uint64_t)atlas->width * atlas->height * 4 || mesh->width == 0 ||
+        mesh->size != (uint64_t)mesh->width * 8 * sizeof(float)) {
+        return false;
+    }
+
+    const char* base = (const char*)set->map;
+    set->atlas = (Image){ (void*)(base + atlas->offset), atlas->width, atlas->height, 1, atlas->format };
+    set->lightVs = (char*)(base + vs->offset);
+    set->lightFs = (char*)(base + fs->offset);
+
+    madvise(set->map, set->mapSize, MADV_WILLNEED);
+    LoadJobs jobs = { .set = set, .meshEntry = mesh, .count = ATLAS_TOUCH_JOBS + 1 };
+    runJobs(&jobs, packWorker);
+    return jobs.meshOk;
+}
+
+static bool loadFromSources(AssetSet* set)
+{
+    LoadJobs jobs = { .set = set, .count = ATLAS_LAYER_COUNT + 1 };
+    runJobs(&jobs, sourceWorker);
+
+    set->atlas = BuildAtlasImage(jobs.layers);
+    bool ok = jobs.meshOk;
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) {
+        ok = ok && IsImageValid(jobs.layers[i]);
+        UnloadImage(jobs.layers[i]);
+    }
+    set->lightVs = LoadFileText(ASSET_LIGHT_VS);
+    set->lightFs = LoadFileText(ASSET_LIGHT_FS);
+    return ok && set->lightVs && set->lightFs;
+}
+
+// decoded by raylib or mapped, so not through MemAlloc
+static void accountAssets(AssetSet* set)
+{
+    if (set->map) {
+        set->accounted = set->mapSize;
+    } else {
+        set->accounted = (size_t)set->atlas.width * set->atlas.height * 4;
+        if (set->lightVs) set->accounted += strlen(set->lightVs) + 1;
+        if (set->lightFs) set->accounted += strlen(set->lightFs) + 1;
+    }
+    MemAccount(MEM_ASSETS, (long)set->accounted);
+}
+
+bool LoadAssets(AssetSet* set)
+{
+    *set = (AssetSet){ 0 };
+    if (mapPack(set)) {
+        if (loadFromPack(set)) {
+            accountAssets(set);
+            return true;
+        }
+        printf("assets: %s is incomplete, loading the source files\n", ASSET_PACK_FILE);
+        UnloadAssets(set);
+    }
+    bool ok = loadFromSources(set);
+    accountAssets(set);
+    return ok;
+}
+
+void UnloadAssets(AssetSet* set)
+{
+    MemAccount(MEM_ASSETS, -(long)set->accounted);
+    if (set->map) {
+        munmap(set->map, set->mapSize);
+    } else {
+        UnloadImage(set->atlas);
+        if (set->lightVs) UnloadFileText(set->lightVs);
+        if (set->lightFs) UnloadFileText(set->lightFs);
+    }
+    *set = (AssetSet){ 0 };
+}
+
+static bool writeEntry(FILE* f, AssetEntry* e, const void* a, size_t aSize, const void* b, size_t bSize,
+                       const void* c, size_t cSize)
+{
+    static const char zeros[ASSET_PACK_ALIGN] = { 0 };
+    long at = ftell(f);
+    long pad = (ASSET_PACK_ALIGN - at % ASSET_PACK_ALIGN) % ASSET_PACK_ALIGN;
+    if (pad && fwrite(zeros, 1, pad, f) != (size_t)pad) return false;
+    e->offset = at + pad;
+    e->size = aSize + bSize + cSize;
+    return fwrite(a, 1, aSize, f) == aSize && (!bSize || fwrite(b, 1, bSize, f) == bSize) &&
+           (!cSize || fwrite(c, 1, cSize, f) == cSize);
+}
+
+bool PackAssets(const char* fileName)
+{
+    AssetSet set = { 0 };
+    if (!loadFromSources(&set)) {
+        printf("pack: couldn't load the source assets\n");
+        RL_FREE(set.cylinder.vertices);
+        RL_FREE(set.cylinder.texcoords);
+        RL_FREE(set.cylinder.normals);
+        UnloadAssets(&set);
+        return false;
+    }
+
+    AssetEntry entries[4] = { 0 };
+    snprintf(entries[0].name, sizeof(entries[0].name), "atlas");
+    entries[0].type = ASSET_IMAGE;
+    entries[0].width = set.atlas.width;
+    entries[0].height = set.atlas.height;
+    entries[0].format = set.atlas.format;
+    snprintf(entries[1].name, sizeof(entries[1].name), "%s", ASSET_CYLINDER_OBJ);
+    entries[1].type = ASSET_MESH;
+    entries[1].width = set.cylinder.vertexCount;
+    snprintf(entries[2].name, sizeof(entries[2].name), "%s", ASSET_LIGHT_VS);
+    entries[2].type = ASSET_TEXT;
+    snprintf(entries[3].name, sizeof(entries[3].name), "%s", ASSET_LIGHT_FS);
+    entries[3].type = ASSET_TEXT;
+
+    bool ok = false;
+    FILE* f = fopen(fileName, "wb");
+    if (f) {
+        AssetPackHeader h = { ASSET_PACK_MAGIC, ASSET_PACK_VERSION, 4, 0 };
+        int n = set.cylinder.vertexCount;
+        // header and table go in first as placeholders, rewritten once the offsets are known
+        ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(entries, sizeof(entries), 1, f) == 1 &&
+             writeEntry(f, &entries[0], set.atlas.data, (size_t)set.atlas.width * set.atlas.height * 4,
+                        NULL, 0, NULL, 0) &&
+             writeEntry(f, &entries[1], set.cylinder.vertices, n * 3 * sizeof(float),
+                        set.cylinder.texcoords, n * 2 * sizeof(float), set.cylinder.normals, n * 3 * sizeof(float)) &&
+             writeEntry(f, &entries[2], set.lightVs, strlen(set.lightVs) + 1, NULL, 0, NULL, 0) &&
+             writeEntry(f, &entries[3], set.lightFs, strlen(set.lightFs) + 1, NULL, 0, NULL, 0) &&
+             fseek(f, sizeof(h), SEEK_SET) == 0 && fwrite(entries, sizeof(entries), 1, f) == 1;
+        ok = (fclose(f) == 0) && ok;
+    }
+    if (ok) {
+        printf("pack: wrote %s (atlas %ix%i, %i cylinder vertices)\n", fileName,
+               set.atlas.width, set.atlas.height, set.cylinder.vertexCount);
+    } else {
+        printf("pack: failed writing %s\n", fileName);
+    }
+
+    RL_FREE(set.cylinder.vertices);
+    RL_FREE(set.cylinder.texcoords);
+    RL_FREE(set.cylinder.normals);
+    UnloadAssets(&set);
+    return ok;
+}
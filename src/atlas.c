@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+
+#include "raylib.h"
+#include "atlas.h"
+
+static const char* layerFiles[ATLAS_LAYER_COUNT] = {
+    "data/ball.png", "data/beach-ball.png", "data/earth.png",
+    "data/crate.png", "data/grid.png",
+    "data/drum.png", "data/cylinder2.png",
+    "data/grass.png"
+};
+
+const char* AtlasLayerFile(int layer)
+{
+    return (layer >= 0 && layer < ATLAS_LAYER_COUNT) ? layerFiles[layer] : NULL;
+}
+
+Image LoadAtlasLayer(int layer)
+{
+    Image img = LoadImage(layerFiles[layer]);
+    if (!IsImageValid(img)) {
+        printf("atlas: failed to load %s\n", layerFiles[layer]);
+        return img;
+    }
+    ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (img.width != ATLAS_LAYER_SIZE || img.height != ATLAS_LAYER_SIZE) {
+        ImageResize(&img, ATLAS_LAYER_SIZE, ATLAS_LAYER_SIZE);
+    }
+    return img;
+}
+
+static void atlasSize(int* w, int* h)
+{
+    const int cell = ATLAS_LAYER_SIZE + ATLAS_GUTTER * 2;
+    *w = cell * ATLAS_COLUMNS;
+    *h = cell * ((ATLAS_LAYER_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS);
+}
+
+static Vector2 layerOrigin(int layer)
+{
+    const int cell = ATLAS_LAYER_SIZE + ATLAS_GUTTER * 2;
+    return (Vector2){ (layer % ATLAS_COLUMNS) * cell + ATLAS_GUTTER,
+                      (layer / ATLAS_COLUMNS) * cell + ATLAS_GUTTER };
+}
+
+Image BuildAtlasImage(const Image* layers)
+{
+    int w, h;
+    atlasSize(&w, &h);
+    Image img = GenImageColor(w, h, BLANK);
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) {
+        if (!IsImageValid(layers[i])) continue;
+
+        // the layer plus its neighbouring copies clipped to the gutter,
+        // most textures tile so the border wraps rather than clamps
+        const Vector2 o = layerOrigin(i);
+        const float s = ATLAS_LAYER_SIZE;
+        const float g = ATLAS_GUTTER;
+        for (int ty = -1; ty <= 1; ty++) {
+            for (int tx = -1; tx <= 1; tx++) {
+                Rectangle src = { 0, 0, s, s };
+                if (tx < 0) src.x = s - g;
+                if (ty < 0) src.y = s - g;
+                if (tx != 0) src.width = g;
+                if (ty != 0) src.height = g;
+                Rectangle dst = { tx < 0 ? o.x - g : o.x + tx * s, ty < 0 ? o.y - g : o.y + ty * s,
+                                  src.width, src.height };
+                ImageDraw(&img, layers[i], src, dst, WHITE);
+            }
+        }
+    }
+    return img;
+}
+
+void LoadTextureAtlasFromImage(TextureAtlas* atlas, Image img)
+{
+    int w, h;
+    atlasSize(&w, &h);
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) {
+        const Vector2 o = layerOrigin(i);
+        atlas->rects[i] = (Vector4){ o.x / w, o.y / h,
+                                     (float)ATLAS_LAYER_SIZE / w, (float)ATLAS_LAYER_SIZE / h };
+    }
+
+    atlas->texture = LoadTextureFromImage(img);
+    GenTextureMipmaps(&atlas->texture);
+    SetTextureFilter(atlas->texture, TEXTURE_FILTER_TRILINEAR);
+}
+
+bool LoadTextureAtlas(TextureAtlas* atlas)
+{
+    Image layers[ATLAS_LAYER_COUNT];
+    bool ok = true;
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) {
+        layers[i] = LoadAtlasLayer(i);
+        ok = ok && IsImageValid(layers[i]);
+    }
+    Image img = BuildAtlasImage(layers);
+    for (int i = 0; i < ATLAS_LAYER_COUNT; i++) UnloadImage(layers[i]);
+    LoadTextureAtlasFromImage(atlas, img);
+    UnloadImage(img);
+    return ok;
+}
+
+void UnloadTextureAtlas(TextureAtlas* atlas)
+{
+    UnloadTexture(atlas->texture);
+    atlas->texture = (Texture){ 0 };
+}
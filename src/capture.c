@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define GL_GLEXT_PROTOTYPES
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#include "raylib.h"
+#include "capture.h"
+#include "memtrack.h"
+
+static void* writerThread(void* data)
+{
+    Capture* cap = (Capture*)data;
+    const size_t stride = (size_t)cap->width * 4;
+
+    for (;;) {
+        pthread_mutex_lock(&cap->lock);
+        while (cap->queued == 0 && !cap->stopping) pthread_cond_wait(&cap->wake, &cap->lock);
+        if (cap->queued == 0) {
+            pthread_mutex_unlock(&cap->lock);
+            break;
+        }
+        unsigned char* px = cap->frames[cap->queueHead];
+        long number = cap->frameNumbers[cap->queueHead];
+        pthread_mutex_unlock(&cap->lock);
+
+        // GL rows are bottom up
+        if (cap->format == CAPTURE_RAW) {
+            for (int y = cap->height - 1; y >= 0; y--) fwrite(px + y * stride, 1, stride, cap->raw);
+        } else {
+            unsigned char row[stride];
+            for (int y = 0; y < cap->height / 2; y++) {
+                unsigned char* a = px + y * stride;
+                unsigned char* b = px + (cap->height - 1 - y) * stride;
+                memcpy(row, a, stride);
+                memcpy(a, b, stride);
+                memcpy(b, row, stride);
+            }
+            // not TextFormat, its buffers are the main thread's (HUD)
+            char name[sizeof(cap->dir) + 32];
+            snprintf(name, sizeof(name), "%s/frame_%06li.png", cap->dir, number);
+            Image img = { px, cap->width, cap->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            ExportImage(img, name);
+        }
+
+        pthread_mutex_lock(&cap->lock);
+        cap->queueHead = (cap->queueHead + 1) % CAPTURE_QUEUE_SIZE;
+        cap->queued--;
+        cap->written++;
+        pthread_mutex_unlock(&cap->lock);
+    }
+    return NULL;
+}
+
+bool InitCapture(Capture* cap, int width, int height, CaptureFormat format, const char* dir)
+{
+    memset(cap, 0, sizeof(Capture));
+    cap->width = width;
+    cap->height = height;
+    cap->format = format;
+    snprintf(cap->dir, sizeof(cap->dir), "%s", dir);
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        printf("capture: can't create %s\n", dir);
+        return false;
+    }
+    if (format == CAPTURE_RAW) {
+        const char* name = TextFormat("%s/capture_%ix%i.rgba", dir, width, height);
+        cap->raw = fopen(name, "wb");
+        if (!cap->raw) {
+            printf("capture: can't write %s\n", name);
+            return false;
+        }
+    }
+
+    cap->target = LoadRenderTexture(width, height);
+    if (!IsRenderTextureValid(cap->target)) {
+        printf("capture: couldn't create a %ix%i render texture\n", width, height);
+        UnloadRenderTexture(cap->target);
+        cap->target = (RenderTexture2D){ 0 };
+        if (cap->raw) fclose(cap->raw);
+        return false;
+    }
+
+    const size_t size = (size_t)width * height * 4;
+    glGenBuffers(CAPTURE_PBO_COUNT, cap->pbos);
+    for (int i = 0; i < CAPTURE_PBO_COUNT; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, cap->pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    for (int i = 0; i < CAPTURE_QUEUE_SIZE; i++) cap->frames[i] = MemAlloc(MEM_RENDER, size);
+
+    pthread_mutex_init(&cap->lock, NULL);
+    pthread_cond_init(&cap->wake, NULL);
+    pthread_create(&cap->writer, NULL, writerThread, cap);
+    return true;
+}
+
+void BeginCapture(Capture* cap)
+{
+    BeginTextureMode(cap->target);
+}
+
+// hand the oldest readback to the writer, returns false if it's not
+// ready yet and wait wasn't asked for
+static bool collectOldest(Capture* cap, bool wait)
+{
+    const int i = cap->pboTail;
+    GLsync fence = (GLsync)cap->fences[i];
+    GLenum r = glClientWaitSync(fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                wait ? 1000000000ull : 0);
+    if (r == GL_TIMEOUT_EXPIRED) return false;
+    glDeleteSync(fence);
+    // a failed wait says nothing about the copy, the frame is lost
+    const bool failed = (r == GL_WAIT_FAILED);
+
+    // a free buffer is never touched by the writer until it's queued
+    pthread_mutex_lock(&cap->lock);
+    int slot = (cap->queued < CAPTURE_QUEUE_SIZE) ? (cap->queueHead + cap->queued) % CAPTURE_QUEUE_SIZE : -1;
+    pthread_mutex_unlock(&cap->lock);
+
+    if (slot >= 0 && !failed) {
+        const size_t size = (size_t)cap->width * cap->height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, cap->pbos[i]);
+        const void* px = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (px) {
+            memcpy(cap->frames[slot], px, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        pthread_mutex_lock(&cap->lock);
+        if (px) {
+            cap->frameNumbers[slot] = cap->captured - cap->pboPending;
+            cap->queued++;
+            pthread_cond_signal(&cap->wake);
+        } else {
+            cap->dropped++;
+        }
+        pthread_mutex_unlock(&cap->lock);
+    } else {
+        cap->dropped++;
+    }
+
+    cap->pboTail = (cap->pboTail + 1) % CAPTURE_PBO_COUNT;
+    cap->pboPending--;
+    return true;
+}
+
+void EndCapture(Capture* cap)
+{
+    EndTextureMode();   // flushes raylib's batch into the target
+
+    // only block when the ring is full, by then the oldest is a couple
+    // of frames old and long since finished
+    while (cap->pboPending > 0 && collectOldest(cap, cap->pboPending == CAPTURE_PBO_COUNT)) { }
+
+    // the read goes into the buffer object, so returns without waiting
+    const int i = (cap->pboTail + cap->pboPending) % CAPTURE_PBO_COUNT;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, cap->target.id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, cap->pbos[i]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, cap->width, cap->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    cap->fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    cap->pboPending++;
+    cap->captured++;
+}
+
+void FreeCapture(Capture* cap)
+{
+    if (!cap->target.id) return;
+
+    while (cap->pboPending > 0) collectOldest(cap, true);
+
+    pthread_mutex_lock(&cap->lock);
+    cap->stopping = true;
+    pthread_cond_signal(&cap->wake);
+    pthread_mutex_unlock(&cap->lock);
+    pthread_join(cap->writer, NULL);
+    pthread_mutex_destroy(&cap->lock);
+    pthread_cond_destroy(&cap->wake);
+
+    if (cap->raw) fclose(cap->raw);
+    for (int i = 0; i < CAPTURE_QUEUE_SIZE; i++) MemFree(cap->frames[i]);
+    glDeleteBuffers(CAPTURE_PBO_COUNT, cap->pbos);
+    UnloadRenderTexture(cap->target);
+
+    printf("capture: %li frames, %li written, %li dropped\n", cap->captured, cap->written, cap->dropped);
+    cap->target = (RenderTexture2D){ 0 };
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <math.h>
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "ccd.h"
+
+typedef struct Sweep {
+    dGeomID ray;
+    dBodyID body;
+    void* owner;                // ragdoll / vehicle, its other parts are ignored
+    bool hit;
+    dContactGeom nearest;
+} Sweep;
+
+static void* bodyOwner(dBodyID b)
+{
+    BodyOwner* o = (BodyOwner*)dBodyGetData(b);
+    return o ? o->owner : NULL;
+}
+
+// half the smallest extent of a body's geoms, as far as a sweep cares
+// the radius of the sphere it stands in for
+static float bodyThickness(dBodyID b)
+{
+    float t = INFINITY;
+    for (dGeomID g = dBodyGetFirstGeom(b); g; g = dBodyGetNextGeom(g)) {
+        dReal r, l;
+        dVector3 len;
+        switch (dGeomGetClass(g)) {
+            case dSphereClass:
+                r = dGeomSphereGetRadius(g);
+                break;
+            case dBoxClass:
+                dGeomBoxGetLengths(g, len);
+                r = fminf(len[0], fminf(len[1], len[2])) / 2;
+                break;
+            case dCapsuleClass:
+                dGeomCapsuleGetParams(g, &r, &l);
+                break;
+            case dCylinderClass:
+                dGeomCylinderGetParams(g, &r, &l);
+                r = fminf(r, l / 2);
+                break;
+            default: {
+                dReal aabb[6];
+                dGeomGetAABB(g, aabb);
+                r = fminf(aabb[1] - aabb[0], fminf(aabb[3] - aabb[2], aabb[5] - aabb[4])) / 2;
+            }
+        }
+        t = fminf(t, r);
+    }
+    return t;
+}
+
+static void sweepCallback(void* data, dGeomID o1, dGeomID o2)
+{
+    Sweep* s = (Sweep*)data;
+    dGeomID g = (o1 == s->ray) ? o2 : o1;
+
+    // the same rules as nearCallback, plus the body's own parts
+    geomInfo* gi = (geomInfo*)dGeomGetData(g);
+    if (gi && (!gi->collidable || gi->trigger)) return;
+    dBodyID b = dGeomGetBody(g);
+    if (b) {
+        if (b == s->body) return;
+        if (s->owner && bodyOwner(b) == s->owner) return;
+        if (dAreConnectedExcluding(b, s->body, dJointTypeContact)) return;
+    }
+
+    dContactGeom c;
+    if (!dCollide(s->ray, g, 1, &c, sizeof(dContactGeom))) return;
+    if (s->hit && c.depth >= s->nearest.depth) return;
+    s->nearest = c;
+    s->hit = true;
+}
+
+int ClampFastBodies(PhysicsContext* ctx, float slice)
+{
+    Sweep s;
+    s.ray = ctx->ccdRay;
+    int clamped = 0;
+
+    int ng = dSpaceGetNumGeoms(*ctx->space);
+    for (int i = 0; i < ng; i++) {
+        dGeomID g = dSpaceGetGeom(*ctx->space, i);
+        dBodyID b = dGeomGetBody(g);
+        // a body with several geoms is only swept from its first
+        if (!b || dBodyGetFirstGeom(b) != g || !dBodyIsEnabled(b) || dBodyIsKinematic(b)) continue;
+
+        const dReal* v = dBodyGetLinearVel(b);
+        const float speed = sqrtf(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+        const float travel = speed * slice;
+        const float radius = bodyThickness(b);
+        if (travel <= radius * CCD_TRAVEL_FRACTION) continue;
+
+        const dReal* p = dBodyGetPosition(b);
+        const float d[3] = { v[0] / speed, v[1] / speed, v[2] / speed };
+        dGeomRaySetLength(s.ray, travel + radius);
+        dGeomRaySet(s.ray, p[0], p[1], p[2], d[0], d[1], d[2]);
+        s.body = b;
+        s.owner = bodyOwner(b);
+        s.hit = false;
+        dSpaceCollide2(s.ray, (dGeomID)*ctx->space, &s, &sweepCallback);
+        if (!s.hit) continue;
+
+        // normal facing back along the path
+        float n[3] = { s.nearest.normal[0], s.nearest.normal[1], s.nearest.normal[2] };
+        float facing = n[0]*d[0] + n[1]*d[1] + n[2]*d[2];
+        if (facing > 0) {
+            for (int k = 0; k < 3; k++) n[k] = -n[k];
+            facing = -facing;
+        }
+        // the centre line was already inside or touching, contacts have it
+        const float gap = (s.nearest.depth - radius) * -facing;
+        if (gap <= 0) continue;
+
+        // closing speed against the hit surface, which may be moving too
+        dVector3 other = { 0, 0, 0 };
+        dBodyID ob = dGeomGetBody(s.nearest.g2 == s.ray ? s.nearest.g1 : s.nearest.g2);
+        if (ob) dBodyGetPointVel(ob, s.nearest.pos[0], s.nearest.pos[1], s.nearest.pos[2], other);
+        const float closing = -((v[0] - other[0]) * n[0] + (v[1] - other[1]) * n[1] + (v[2] - other[2]) * n[2]);
+        const float allowed = gap * CCD_MARGIN / slice;
+        if (closing <= allowed) continue;
+
+        const float cut = closing - allowed;
+        dBodySetLinearVel(b, v[0] + n[0] * cut, v[1] + n[1] * cut, v[2] + n[2] * cut);
+        clamped++;
+    }
+    return clamped;
+}
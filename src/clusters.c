@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "clusters.h"
+#include "memtrack.h"
+
+bool InitClusterLighting(ClusterLighting* cl)
+{
+    cl->count = 0;
+    cl->indexCount = 0;
+    cl->overflow = 0;
+    cl->lightData = MemCalloc(MEM_RENDER, MAX_POINT_LIGHTS * 2 * 4, sizeof(float));
+    cl->gridData = MemCalloc(MEM_RENDER, CLUSTER_COUNT * 4, sizeof(float));
+    cl->indexData = MemCalloc(MEM_RENDER, MAX_CLUSTER_INDICES, sizeof(float));
+    if (!cl->lightData || !cl->gridData || !cl->indexData) {
+        FreeClusterLighting(cl);
+        return false;
+    }
+
+    // all addressed with texelFetch so filtering doesn't matter
+    cl->lightTex = rlLoadTexture(cl->lightData, 2, MAX_POINT_LIGHTS, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+    cl->gridTex = rlLoadTexture(cl->gridData, CLUSTER_X * CLUSTER_Y, CLUSTER_Z, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+    cl->indexTex = rlLoadTexture(cl->indexData, CLUSTER_INDEX_WIDTH, MAX_CLUSTER_INDICES / CLUSTER_INDEX_WIDTH,
+                                 PIXELFORMAT_UNCOMPRESSED_R32, 1);
+    return cl->lightTex && cl->gridTex && cl->indexTex;
+}
+
+int AddPointLight(ClusterLighting* cl, Vector3 position, float radius, Color color)
+{
+    if (cl->count >= MAX_POINT_LIGHTS) return -1;
+    cl->lights[cl->count] = (PointLight){ position, radius,
+                                          (Vector3){ color.r/255.0f, color.g/255.0f, color.b/255.0f } };
+    return cl->count++;
+}
+
+// range of tiles whose side planes (through the eye) the sphere touches,
+// boundaries are at tan(half fov) * (-1 .. 1) across n tiles
+static bool tileRange(float c, float depth, float r, float tanHalf, int n, int* first, int* last)
+{
+    *first = n;
+    *last = -1;
+    for (int i = 0; i < n; i++) {
+        float lo = (-1.0f + 2.0f * i / n) * tanHalf;
+        float hi = (-1.0f + 2.0f * (i + 1) / n) * tanHalf;
+        // signed distances to the planes x = lo * depth and x = hi * depth
+        float dLo = (c - lo * depth) / sqrtf(1 + lo * lo);
+        float dHi = (hi * depth - c) / sqrtf(1 + hi * hi);
+        if (dLo >= -r && dHi >= -r) {
+            if (i < *first) *first = i;
+            *last = i;
+        }
+    }
+    return *last >= 0;
+}
+
+static int depthSlice(float depth)
+{
+    if (depth <= CLUSTER_DEPTH_NEAR) return 0;
+    int s = (int)(logf(depth / CLUSTER_DEPTH_NEAR) * (CLUSTER_Z / logf(CLUSTER_DEPTH_FAR / CLUSTER_DEPTH_NEAR)));
+    return s < CLUSTER_Z ? s : CLUSTER_Z - 1;
+}
+
+void UpdateClusterLighting(ClusterLighting* cl, Camera camera, float aspect)
+{
+    // cluster bounds of each light, reused by both passes
+    static struct { short x0, x1, y0, y1, z0, z1; } box[MAX_POINT_LIGHTS];
+    static int counts[CLUSTER_COUNT];
+
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    const float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+    const float tanX = tanY * aspect;
+
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < cl->count; i++) {
+        const PointLight* l = &cl->lights[i];
+        Vector3 v = Vector3Transform(l->position, view);
+        float depth = -v.z;
+        box[i].x1 = -1;
+        if (depth + l->radius <= 0) continue;     // behind the camera
+
+        int x0, x1, y0, y1;
+        if (!tileRange(v.x, depth, l->radius, tanX, CLUSTER_X, &x0, &x1)) continue;
+        if (!tileRange(v.y, depth, l->radius, tanY, CLUSTER_Y, &y0, &y1)) continue;
+        box[i].x0 = x0; box[i].x1 = x1;
+        box[i].y0 = y0; box[i].y1 = y1;
+        box[i].z0 = depthSlice(depth - l->radius);
+        box[i].z1 = depthSlice(depth + l->radius);
+
+        for (int z = box[i].z0; z <= box[i].z1; z++)
+            for (int y = y0; y <= y1; y++)
+                for (int x = x0; x <= x1; x++)
+                    counts[x + y * CLUSTER_X + z * CLUSTER_X * CLUSTER_Y]++;
+    }
+
+    // prefix sum gives each cluster its run of indices
+    int total = 0;
+    cl->overflow = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++) {
+        int n = counts[c];
+        if (total + n > MAX_CLUSTER_INDICES) {
+            cl->overflow += total + n - MAX_CLUSTER_INDICES;
+            n = MAX_CLUSTER_INDICES - total;
+        }
+        cl->gridData[c * 4 + 0] = total;
+        cl->gridData[c * 4 + 1] = 0;      // filled in below
+        counts[c] = n;
+        total += n;
+    }
+    cl->indexCount = total;
+
+    for (int i = 0; i < cl->count; i++) {
+        if (box[i].x1 < 0) continue;
+        for (int z = box[i].z0; z <= box[i].z1; z++)
+            for (int y = box[i].y0; y <= box[i].y1; y++)
+                for (int x = box[i].x0; x <= box[i].x1; x++) {
+                    int c = x + y * CLUSTER_X + z * CLUSTER_X * CLUSTER_Y;
+                    float* cell = &cl->gridData[c * 4];
+                    if (cell[1] >= counts[c]) continue;
+                    cl->indexData[(int)cell[0] + (int)cell[1]] = i;
+                    cell[1] += 1;
+                }
+    }
+
+    for (int i = 0; i < cl->count; i++) {
+        const PointLight* l = &cl->lights[i];
+        float* d = &cl->lightData[i * 8];
+        d[0] = l->position.x; d[1] = l->position.y; d[2] = l->position.z; d[3] = l->radius;
+        d[4] = l->color.x; d[5] = l->color.y; d[6] = l->color.z; d[7] = 1;
+    }
+
+    if (cl->count) {
+        rlUpdateTexture(cl->lightTex, 0, 0, 2, cl->count, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, cl->lightData);
+    }
+    rlUpdateTexture(cl->gridTex, 0, 0, CLUSTER_X * CLUSTER_Y, CLUSTER_Z,
+                    PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, cl->gridData);
+    int rows = (total + CLUSTER_INDEX_WIDTH - 1) / CLUSTER_INDEX_WIDTH;
+    if (rows) {
+        rlUpdateTexture(cl->indexTex, 0, 0, CLUSTER_INDEX_WIDTH, rows, PIXELFORMAT_UNCOMPRESSED_R32, cl->indexData);
+    }
+}
+
+void BindClusterLighting(const ClusterLighting* cl)
+{
+    rlActiveTextureSlot(CLUSTER_TEXTURE_SLOT);
+    rlEnableTexture(cl->gridTex);
+    rlActiveTextureSlot(CLUSTER_TEXTURE_SLOT + 1);
+    rlEnableTexture(cl->indexTex);
+    rlActiveTextureSlot(CLUSTER_TEXTURE_SLOT + 2);
+    rlEnableTexture(cl->lightTex);
+    rlActiveTextureSlot(0);
+}
+
+void FreeClusterLighting(ClusterLighting* cl)
+{
+    if (cl->lightTex) rlUnloadTexture(cl->lightTex);
+    if (cl->gridTex) rlUnloadTexture(cl->gridTex);
+    if (cl->indexTex) rlUnloadTexture(cl->indexTex);
+    cl->lightTex = cl->gridTex = cl->indexTex = 0;
+    MemFree(cl->lightData);
+    MemFree(cl->gridData);
+    MemFree(cl->indexData);
+    cl->lightData = cl->gridData = cl->indexData = NULL;
+    cl->count = 0;
+}
@@ -21,15 +21,177 @@
  *
  */
 
+#include <math.h>
+#include <stdlib.h>
+#include <stdint.h>
+
 #include "collision.h"
 #include "raylibODE.h"
 #include "init.h"
+#include "raylibODEragdoll.h"
+#include "memtrack.h"
 
-#define MAX_CONTACTS 8
+// a broadphase pair held back until the step's pairs can be sorted
+typedef struct GeomPair {
+    dGeomID o1, o2;
+} GeomPair;
 
-void nearCallback(void *data, dGeomID o1, dGeomID o2)
+// dCollide can give up to this many, ReduceContacts trims them to the
+// budget for the shape pair
+#define MAX_CONTACTS CONTACT_CACHE_POINTS
+
+// contacts kept per pair of shapes, sphere box capsule cylinder (see
+// the ODE class enum) anything else gets 4. A sphere only ever touches
+// at one point and a capsule along a line, 4 spread points hold any
+// face contact as well as the full 8 do
+static const unsigned char contactBudgets[5][5] = {
+    //  sph box cap cyl convex
+    {   1,  1,  1,  1,  1 },    // sphere
+    {   1,  4,  2,  4,  4 },    // box
+    {   1,  2,  2,  2,  2 },    // capsule
+    {   1,  4,  2,  4,  4 },    // cylinder
+    {   1,  4,  2,  4,  4 },    // convex
+};
+
+static int contactBudget(dGeomID o1, dGeomID o2)
+{
+    int c1 = dGeomGetClass(o1);
+    int c2 = dGeomGetClass(o2);
+    if (c1 > dConvexClass || c2 > dConvexClass) return 4;
+    // planes and rays sit between cylinder and convex in the enum
+    if (c1 > dCylinderClass) c1 = 4;
+    if (c2 > dCylinderClass) c2 = 4;
+    return contactBudgets[c1][c2];
+}
+
+static float distanceSq(const dReal* a, const dReal* b)
+{
+    const float x = a[0] - b[0], y = a[1] - b[1], z = a[2] - b[2];
+    return x*x + y*y + z*z;
+}
+
+// twice the area of abc, along n (or its size if n is NULL)
+static float triangleArea(const dReal* a, const dReal* b, const dReal* c, const float* n)
+{
+    const float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    const float x = u[1]*v[2] - u[2]*v[1], y = u[2]*v[0] - u[0]*v[2], z = u[0]*v[1] - u[1]*v[0];
+    if (n) return x*n[0] + y*n[1] + z*n[2];
+    return sqrtf(x*x + y*y + z*z);
+}
+
+static void swapContacts(dContact* c, int a, int b)
+{
+    dContact t = c[a];
+    c[a] = c[b];
+    c[b] = t;
+}
+
+int ReduceContacts(dContact* contact, int count, int budget)
+{
+    if (count <= budget) return count;
+
+    // deepest first, it's the one doing the most pushing
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        if (contact[i].geom.depth > contact[best].geom.depth) best = i;
+    }
+    swapContacts(contact, 0, best);
+    if (budget == 1) return 1;
+
+    // then the furthest from it
+    const dReal* p0 = contact[0].geom.pos;
+    best = 1;
+    for (int i = 2; i < count; i++) {
+        if (distanceSq(contact[i].geom.pos, p0) > distanceSq(contact[best].geom.pos, p0)) best = i;
+    }
+    swapContacts(contact, 1, best);
+    if (budget == 2) return 2;
+
+    // the one making the biggest triangle with those two
+    const dReal* p1 = contact[1].geom.pos;
+    best = 2;
+    float bestArea = -1;
+    for (int i = 2; i < count; i++) {
+        float a = triangleArea(p0, p1, contact[i].geom.pos, NULL);
+        if (a > bestArea) {
+            bestArea = a;
+            best = i;
+        }
+    }
+    swapContacts(contact, 2, best);
+    if (budget == 3) return 3;
+
+    // last the point adding the most area outside the triangle, if
+    // everything left is inside it there's nothing worth adding
+    const dReal* p2 = contact[2].geom.pos;
+    const float u[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    const float v[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    const float n[3] = { u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0] };
+    const dReal* edges[3][2] = { { p0, p1 }, { p1, p2 }, { p2, p0 } };
+    best = -1;
+    bestArea = 0;
+    for (int i = 3; i < count; i++) {
+        for (int e = 0; e < 3; e++) {
+            // negative along n means the point is across this edge
+            float a = -triangleArea(edges[e][0], edges[e][1], contact[i].geom.pos, n);
+            if (a > bestArea) {
+                bestArea = a;
+                best = i;
+            }
+        }
+    }
+    if (best < 0) return 3;
+    swapContacts(contact, 3, best);
+    return 4;
+}
+
+static unsigned int geomSerial(dGeomID g)
+{
+    geomInfo* gi = (geomInfo*)dGeomGetData(g);
+    return gi ? gi->serial : 0;
+}
+
+// by serial, geoms without one (vehicle chassis) fall back on where
+// they are, which is just as repeatable if everything before it was.
+// Total (qsort isn't stable), the address settles the last ties
+static int compareGeoms(dGeomID a, dGeomID b)
+{
+    const unsigned int sa = geomSerial(a), sb = geomSerial(b);
+    if (sa != sb) return sa < sb ? -1 : 1;
+    if (a == b) return 0;
+    dReal ba[6], bb[6];
+    dGeomGetAABB(a, ba);
+    dGeomGetAABB(b, bb);
+    for (int i = 0; i < 6; i++) {
+        if (ba[i] != bb[i]) return ba[i] < bb[i] ? -1 : 1;
+    }
+    return (uintptr_t)a < (uintptr_t)b ? -1 : 1;
+}
+
+static int comparePairs(const void* a, const void* b)
+{
+    const GeomPair* pa = (const GeomPair*)a;
+    const GeomPair* pb = (const GeomPair*)b;
+    int c = compareGeoms(pa->o1, pb->o1);
+    return c ? c : compareGeoms(pa->o2, pb->o2);
+}
+
+static bool queuePair(struct PhysicsContext* ctx, dGeomID o1, dGeomID o2)
+{
+    if (ctx->queuedPairs == ctx->pairCapacity) {
+        int capacity = ctx->pairCapacity ? ctx->pairCapacity * 2 : 1024;
+        GeomPair* pairs = MemRealloc(MEM_CONTACTS, ctx->pairs, capacity * sizeof(GeomPair));
+        if (!pairs) return false;
+        ctx->pairs = pairs;
+        ctx->pairCapacity = capacity;
+    }
+    ctx->pairs[ctx->queuedPairs++] = (GeomPair){ o1, o2 };
+    return true;
+}
+
+static void collidePair(struct PhysicsContext* ctx, dGeomID o1, dGeomID o2)
 {
-    struct PhysicsContext* ctx = (struct PhysicsContext*)data;
     int i;
 
     // exit without doing anything if the two bodies are connected by a joint
@@ -38,6 +200,13 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
     //if (b1==b2) return;
     if (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact))
         return;
+
+    // shard ghosts are kinematic, they only push the real bodies about
+    // (and aren't anything a trigger should hear of)
+    if ((!b1 || dBodyIsKinematic(b1)) && (!b2 || dBodyIsKinematic(b2))) return;
+
+    // sensors just note who is inside them
+    if (TriggerCollide(o1, o2)) return;
         
     geomInfo* gi1 = (geomInfo*)dGeomGetData(o1);
     if (gi1 && !gi1->collidable) return;
@@ -59,8 +228,11 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
         contact[i].surface.bounce_vel = 0.001;
 
     }
-    int numc = dCollide(o1, o2, MAX_CONTACTS, &contact[0].geom,
-                        sizeof(dContact));
+    int numc = CollideCached(&ctx->contacts, o1, o2, MAX_CONTACTS, &contact[0].geom,
+                             sizeof(dContact));
+    if (ctx->reduceContacts) numc = ReduceContacts(contact, numc, contactBudget(o1, o2));
+    ctx->contactCount += numc;
+    if (numc && ctx->ragdollLod) NoteRagdollContact(b1, b2);
     if (numc) {
         dMatrix3 RI;
         dRSetIdentity(RI);
@@ -71,3 +243,31 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
         }
     }
 }
+
+void nearCallback(void *data, dGeomID o1, dGeomID o2)
+{
+    struct PhysicsContext* ctx = (struct PhysicsContext*)data;
+    ctx->pairCount++;
+
+    // the broadphase can hand a pair over either way round, the
+    // contact cache wants it the same way every step. Addresses do
+    // that (as integers, < on unrelated pointers isn't defined) but
+    // aren't the same from run to run, serials are
+    const bool swap = ctx->deterministic ? compareGeoms(o2, o1) < 0 : (uintptr_t)o2 < (uintptr_t)o1;
+    if (swap) {
+        dGeomID t = o1;
+        o1 = o2;
+        o2 = t;
+    }
+
+    // kept for CollideQueuedPairs, unless there's no room
+    if (ctx->deterministic && queuePair(ctx, o1, o2)) return;
+    collidePair(ctx, o1, o2);
+}
+
+void CollideQueuedPairs(struct PhysicsContext* ctx)
+{
+    qsort(ctx->pairs, ctx->queuedPairs, sizeof(GeomPair), comparePairs);
+    for (int i = 0; i < ctx->queuedPairs; i++) collidePair(ctx, ctx->pairs[i].o1, ctx->pairs[i].o2);
+    ctx->queuedPairs = 0;
+}
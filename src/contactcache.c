@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "raylib.h"
+#include <ode/ode.h>
+#include "contactcache.h"
+#include "memtrack.h"
+
+bool InitContactCache(ContactCache* cache)
+{
+    memset(cache, 0, sizeof(ContactCache));
+    // calloc'd entries have step 0, which never matches
+    cache->step = 1;
+    cache->tables[0] = MemCalloc(MEM_CONTACTS, CONTACT_CACHE_SLOTS, sizeof(ContactCacheEntry));
+    cache->tables[1] = MemCalloc(MEM_CONTACTS, CONTACT_CACHE_SLOTS, sizeof(ContactCacheEntry));
+    return cache->tables[0] && cache->tables[1];
+}
+
+void FreeContactCache(ContactCache* cache)
+{
+    MemFree(cache->tables[0]);
+    MemFree(cache->tables[1]);
+    cache->tables[0] = cache->tables[1] = NULL;
+}
+
+void ContactCacheBeginStep(ContactCache* cache)
+{
+    // the table from two steps ago becomes this step's, its stale
+    // entries already count as empty
+    cache->step++;
+    cache->current ^= 1;
+    cache->used = 0;
+    cache->hits = 0;
+}
+
+void ClearContactCache(ContactCache* cache)
+{
+    // neither table's entries can match step or step - 1 any more
+    cache->step += 2;
+    cache->used = 0;
+}
+
+void ContactCacheForgetGeom(ContactCache* cache, dGeomID g)
+{
+    // the entries keep their step so probing still runs past them,
+    // a NULL pair just never matches
+    for (int t = 0; t < 2; t++) {
+        ContactCacheEntry* table = cache->tables[t];
+        if (!table) continue;
+        for (int s = 0; s < CONTACT_CACHE_SLOTS; s++) {
+            if (table[s].g1 == g || table[s].g2 == g) table[s].g1 = table[s].g2 = NULL;
+        }
+    }
+}
+
+static unsigned int pairSlot(dGeomID a, dGeomID b)
+{
+    uint64_t h = (uint64_t)(uintptr_t)a * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uintptr_t)b * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    return (unsigned int)h & (CONTACT_CACHE_SLOTS - 1);
+}
+
+static ContactCacheEntry* findEntry(ContactCacheEntry* table, unsigned int step, dGeomID a, dGeomID b)
+{
+    for (unsigned int s = pairSlot(a, b), n = 0; n < CONTACT_CACHE_SLOTS; s = (s + 1) & (CONTACT_CACHE_SLOTS - 1), n++) {
+        ContactCacheEntry* e = &table[s];
+        if (e->step != step) return NULL;
+        if (e->g1 == a && e->g2 == b) return e;
+    }
+    return NULL;
+}
+
+// a free slot in the current table, NULL once it's half full
+static ContactCacheEntry* newEntry(ContactCache* cache, dGeomID a, dGeomID b)
+{
+    if (cache->used >= CONTACT_CACHE_SLOTS / 2) return NULL;
+    ContactCacheEntry* table = cache->tables[cache->current];
+    unsigned int s = pairSlot(a, b);
+    while (table[s].step == cache->step) s = (s + 1) & (CONTACT_CACHE_SLOTS - 1);
+    cache->used++;
+    table[s].step = cache->step;
+    table[s].g1 = a;
+    table[s].g2 = b;
+    return &table[s];
+}
+
+// only geoms with a real transform, planes and rays have none
+static bool cacheable(dGeomID g)
+{
+    switch (dGeomGetClass(g)) {
+        case dSphereClass:
+        case dBoxClass:
+        case dCapsuleClass:
+        case dCylinderClass:
+        case dConvexClass:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ODE rotations are 3x4 row major
+static void rotate(const dReal* R, const float* v, float* out)
+{
+    out[0] = R[0] * v[0] + R[1] * v[1] + R[2] * v[2];
+    out[1] = R[4] * v[0] + R[5] * v[1] + R[6] * v[2];
+    out[2] = R[8] * v[0] + R[9] * v[1] + R[10] * v[2];
+}
+
+static void rotateInverse(const dReal* R, const float* v, float* out)
+{
+    out[0] = R[0] * v[0] + R[4] * v[1] + R[8] * v[2];
+    out[1] = R[1] * v[0] + R[5] * v[1] + R[9] * v[2];
+    out[2] = R[2] * v[0] + R[6] * v[1] + R[10] * v[2];
+}
+
+// conjugate(a) * b, quaternions are w x y z as in ODE
+static void quatConjMul(const float* a, const float* b, float* out)
+{
+    out[0] = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    out[1] = a[0] * b[1] - a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+    out[2] = a[0] * b[2] + a[1] * b[3] - a[2] * b[0] - a[3] * b[1];
+    out[3] = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] - a[3] * b[0];
+}
+
+static void relativePose(dGeomID a, dGeomID b, float* pos, float* q)
+{
+    const dReal* pa = dGeomGetPosition(a);
+    const dReal* pb = dGeomGetPosition(b);
+    const float d[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+    rotateInverse(dGeomGetRotation(a), d, pos);
+
+    dQuaternion qa, qb;
+    dGeomGetQuaternion(a, qa);
+    dGeomGetQuaternion(b, qb);
+    quatConjMul(qa, qb, q);
+}
+
+static bool poseClose(const ContactCacheEntry* e, const float* pos, const float* q)
+{
+    const float dx = pos[0] - e->relPos[0], dy = pos[1] - e->relPos[1], dz = pos[2] - e->relPos[2];
+    if (dx*dx + dy*dy + dz*dz > CONTACT_CACHE_LINEAR_TOL * CONTACT_CACHE_LINEAR_TOL) return false;
+
+    // the vector part of the rotation between them is about half the angle
+    float d[4];
+    quatConjMul(e->relQ, q, d);
+    const float half = CONTACT_CACHE_ANGULAR_TOL * 0.5f;
+    return d[1]*d[1] + d[2]*d[2] + d[3]*d[3] <= half * half;
+}
+
+int CollideCached(ContactCache* cache, dGeomID o1, dGeomID o2, int max, dContactGeom* contact, int skip)
+{
+    if (!cache->tables[0] || max > CONTACT_CACHE_POINTS || !cacheable(o1) || !cacheable(o2)) {
+        return dCollide(o1, o2, max, contact, skip);
+    }
+
+    float pos[3], q[4];
+    relativePose(o1, o2, pos, q);
+
+    const dReal* R = dGeomGetRotation(o1);
+    const dReal* origin = dGeomGetPosition(o1);
+    const ContactCacheEntry* prev = findEntry(cache->tables[cache->current ^ 1], cache->step - 1, o1, o2);
+    if (prev && poseClose(prev, pos, q) && prev->count <= max) {
+        // same manifold, moved along with o1
+        for (int i = 0; i < prev->count; i++) {
+            const CachedContact* c = &prev->contacts[i];
+            dContactGeom* out = (dContactGeom*)((char*)contact + i * skip);
+            float p[3], n[3];
+            rotate(R, c->pos, p);
+            rotate(R, c->normal, n);
+            out->pos[0] = origin[0] + p[0];
+            out->pos[1] = origin[1] + p[1];
+            out->pos[2] = origin[2] + p[2];
+            out->normal[0] = n[0];
+            out->normal[1] = n[1];
+            out->normal[2] = n[2];
+            out->depth = c->depth;
+            out->g1 = o1;
+            out->g2 = o2;
+            out->side1 = c->side1;
+            out->side2 = c->side2;
+        }
+        // carried on as is, still measured from where dCollide ran
+        ContactCacheEntry* e = newEntry(cache, o1, o2);
+        if (e) {
+            const unsigned int step = e->step;
+            *e = *prev;
+            e->step = step;
+        }
+        cache->hits++;
+        return prev->count;
+    }
+
+    int n = dCollide(o1, o2, max, contact, skip);
+
+    ContactCacheEntry* e = newEntry(cache, o1, o2);
+    if (e) {
+        memcpy(e->relPos, pos, sizeof(pos));
+        memcpy(e->relQ, q, sizeof(q));
+        e->count = n;
+        for (int i = 0; i < n; i++) {
+            const dContactGeom* in = (const dContactGeom*)((const char*)contact + i * skip);
+            CachedContact* c = &e->contacts[i];
+            const float d[3] = { in->pos[0] - origin[0], in->pos[1] - origin[1], in->pos[2] - origin[2] };
+            const float nw[3] = { in->normal[0], in->normal[1], in->normal[2] };
+            rotateInverse(R, d, c->pos);
+            rotateInverse(R, nw, c->normal);
+            c->depth = in->depth;
+            c->side1 = in->side1;
+            c->side2 = in->side2;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "forcefield.h"
+#include "memtrack.h"
+
+// a ragdoll part is keyed by its doll so the whole doll is pushed once
+typedef struct FieldHit {
+    void* key;
+    dBodyID body;
+    RagDoll* ragdoll;
+} FieldHit;
+
+typedef struct FieldQuery {
+    dGeomID probe;
+    int targets;
+    int count;
+    FieldHit hits[FORCEFIELD_MAX_BODIES];
+} FieldQuery;
+
+// broadphase callback - probe against anything whose AABB it overlaps
+static void queryCallback(void *data, dGeomID o1, dGeomID o2)
+{
+    FieldQuery* q = (FieldQuery*)data;
+    dGeomID g = (o1 == q->probe) ? o2 : o1;
+
+    dBodyID b = dGeomGetBody(g);
+    if (!b || q->count >= FORCEFIELD_MAX_BODIES) return;
+    // ignore things that are never collided (eg vehicle counter weights)
+    geomInfo* gi = (geomInfo*)dGeomGetData(g);
+    if (gi && !gi->collidable) return;
+
+    RagDoll* rd = GetBodyRagdoll(b);
+    if (!(q->targets & (rd ? FORCEFIELD_RAGDOLLS : FORCEFIELD_OBJECTS))) return;
+
+    FieldHit* h = &q->hits[q->count++];
+    h->key = rd ? (void*)rd : (void*)b;
+    h->body = b;
+    h->ragdoll = rd;
+}
+
+// a doll goes by its torso's body (the proxy when it has one), so the
+// jitter is drawn in the same order every run
+static dBodyID hitBody(const FieldHit* h)
+{
+    return h->ragdoll ? dGeomGetBody(h->ragdoll->geoms[RAGDOLL_TORSO]) : h->body;
+}
+
+static int compareHits(const void* a, const void* b)
+{
+    const FieldHit* ha = (const FieldHit*)a;
+    const FieldHit* hb = (const FieldHit*)b;
+    if (ha->key == hb->key) return 0;
+    int c = CompareBodyOrder(hitBody(ha), hitBody(hb));
+    if (c) return c;
+    const uintptr_t pa = (uintptr_t)ha->key;
+    const uintptr_t pb = (uintptr_t)hb->key;
+    return (pa > pb) - (pa < pb);
+}
+
+// acceleration the field gives something at p moving at v, false if unaffected
+static bool fieldAccel(const ForceField* field, Rng* rng, Vector3 p, const dReal* v, Vector3* accel)
+{
+    Vector3 dir;
+    float strength = field->strength;
+
+    if (field->type == FORCEFIELD_EXPLOSION) {
+        Vector3 d = Vector3Subtract(p, field->position);
+        float dist = Vector3Length(d);
+        if (dist >= field->radius) return false;
+        dir = dist > 0.001f ? Vector3Scale(d, 1.0f / dist) : (Vector3){ 0, 1, 0 };
+        strength *= 1.0f - dist / field->radius;
+    } else if (field->type == FORCEFIELD_WIND) {
+        dir = field->direction;
+    } else {
+        dir = (Vector3){ 0, 1, 0 };
+    }
+
+    if (field->maxSpeed > 0) {
+        float along = v[0] * dir.x + v[1] * dir.y + v[2] * dir.z;
+        if (along >= field->maxSpeed) return false;
+    }
+
+    *accel = Vector3Scale(dir, strength);
+    if (field->jitter > 0) {
+        accel->x += RngFloat(rng, -field->jitter, field->jitter);
+        accel->z += RngFloat(rng, -field->jitter, field->jitter);
+    }
+    return true;
+}
+
+static void pushRagdoll(RagDoll* rd, const ForceField* field, Rng* rng)
+{
+    // treat the doll as one rigid lump at its centre of mass
+    const dReal* v = dBodyGetLinearVel(rd->bodies[RAGDOLL_TORSO]);
+    Vector3 a;
+    if (!fieldAccel(field, rng, rd->centerOfMass, v, &a)) return;
+
+    if (!rd->enabled) EnableRagdoll(rd);
+    if (rd->proxy) {
+        dBodyAddForce(rd->proxy, a.x * rd->totalMass, a.y * rd->totalMass, a.z * rd->totalMass);
+        return;
+    }
+    // same acceleration for every part so the pose isn't torn apart
+    for (int i = 0; i < rd->bodyCount; i++) {
+        float m = rd->masses[i];
+        dBodyAddForce(rd->bodies[i], a.x * m, a.y * m, a.z * m);
+    }
+}
+
+static void pushBody(dBodyID b, const ForceField* field, Rng* rng)
+{
+    const dReal* p = dBodyGetPosition(b);
+    const dReal* v = dBodyGetLinearVel(b);
+    Vector3 a;
+    if (!fieldAccel(field, rng, (Vector3){ p[0], p[1], p[2] }, v, &a)) return;
+
+    dMass mass;
+    dBodyGetMass(b, &mass);
+    dBodyEnable(b); // case its gone to sleep
+    dBodyAddForce(b, a.x * mass.mass, a.y * mass.mass, a.z * mass.mass);
+}
+
+int ApplyForceField(PhysicsContext* ctx, const ForceField* field)
+{
+    // too big for the stack, each world keeps its own so worlds on
+    // other threads can apply fields too
+    if (!ctx->fieldQuery) ctx->fieldQuery = MemAlloc(MEM_OTHER, sizeof(FieldQuery));
+    if (!ctx->fieldQuery) return 0;
+    FieldQuery* q = ctx->fieldQuery;
+
+    // position the matching probe shape over the field's volume
+    if (field->type == FORCEFIELD_EXPLOSION) {
+        q->probe = ctx->querySphere;
+        dGeomSphereSetRadius(q->probe, field->radius);
+    } else {
+        q->probe = ctx->queryBox;
+        dGeomBoxSetLengths(q->probe, field->extents.x * 2, field->extents.y * 2, field->extents.z * 2);
+    }
+    dGeomSetPosition(q->probe, field->position.x, field->position.y, field->position.z);
+    q->targets = field->targets;
+    q->count = 0;
+
+    // only the geoms the hash space says overlap the volume are visited
+    dSpaceCollide2(q->probe, (dGeomID)*ctx->space, q, &queryCallback);
+
+    // compounds and ragdolls turn up once per geom
+    qsort(q->hits, q->count, sizeof(FieldHit), compareHits);
+
+    int hits = 0;
+    for (int i = 0; i < q->count; i++) {
+        if (i && q->hits[i].key == q->hits[i-1].key) continue;
+
+        if (q->hits[i].ragdoll) {
+            pushRagdoll(q->hits[i].ragdoll, field, &ctx->rng);
+        } else {
+            pushBody(q->hits[i].body, field, &ctx->rng);
+        }
+        hits++;
+    }
+
+    return hits;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "raylibODEvehicle.h"
+#include "init.h"
+#include "shmserver.h"
+#include "headless.h"
+#include "xform.h"
+#include "collision.h"
+#include "memtrack.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// traffic for the vehicle benchmark
+typedef struct Fleet {
+    vehicle** cars;
+    VehicleControl* controls;
+    int count;
+} Fleet;
+
+static void spawnFleet(Fleet* fleet, PhysicsContext* ctx, int count, VehicleModel model)
+{
+    fleet->cars = MemAlloc(MEM_VEHICLES, count * sizeof(vehicle*));
+    fleet->controls = MemAlloc(MEM_VEHICLES, count * sizeof(VehicleControl));
+    fleet->count = 0;
+    if (!fleet->cars || !fleet->controls) return;
+
+    // grid over the plane leaving the middle to the dolls and objects,
+    // any that don't fit are stacked a layer higher to drop in later
+    const float spacing = 6;
+    VehicleDesc desc = DefaultVehicleDesc();
+    desc.model = model;
+    const int perRow = (int)((PLANE_SIZE - spacing) / spacing);
+    int slot = 0;
+    for (int i = 0; i < count; i++) {
+        Vector3 p;
+        do {
+            int cell = slot % (perRow * perRow);
+            p.x = (cell % perRow) * spacing - (perRow - 1) * spacing / 2;
+            p.z = (cell / perRow) * spacing - (perRow - 1) * spacing / 2;
+            p.y = 2 + (slot / (perRow * perRow)) * 4;
+            slot++;
+        } while (fabsf(p.x) < 15 && fabsf(p.z) < 15);
+
+        vehicle* car = CreateVehicle(*ctx->space, ctx->world, p, &desc);
+        if (!car) return;   // the ones made so far still drive
+        car->slice = ctx->slice;
+        fleet->cars[i] = car;
+        fleet->controls[i] = (VehicleControl){ 0, 0 };
+        fleet->count++;
+    }
+}
+
+static void driveFleet(Fleet* fleet, Rng* rng)
+{
+    // each car occasionally picks a new speed and heading
+    for (int i = 0; i < fleet->count; i++) {
+        if (RngFloat(rng, 0, 1) < 0.002f) {
+            fleet->controls[i].accel = RngFloat(rng, -4, 12);
+            fleet->controls[i].steer = RngFloat(rng, -0.4, 0.4);
+        }
+    }
+    updateVehicles(fleet->cars, fleet->controls, fleet->count, 800.0f, 10.0f);
+}
+
+static void freeFleet(Fleet* fleet, PhysicsContext* ctx)
+{
+    for (int i = 0; i < fleet->count; i++) {
+        FreeVehicle(fleet->cars[i], ctx);
+    }
+    MemFree(fleet->cars);
+    MemFree(fleet->controls);
+    fleet->count = 0;
+}
+
+int RunHeadless(const AppOptions* opts)
+{
+    dSpaceID space;
+
+    PhysicsContext* physCtx = InitPhysics(&space, opts->seed);
+    if (!physCtx) return 1;
+    physCtx->slice = 1.0f / opts->physicsHz;
+    physCtx->ccd = opts->ccd;
+    physCtx->deterministic = opts->deterministic;
+    // a controller drives the joints, they have to stay articulated
+    physCtx->ragdollLod = opts->ragdollLod && !opts->shmName;
+    // no camera, the spawn area is what's being watched
+    physCtx->aoi.enabled = opts->areaOfInterest && !opts->shmName;
+    physCtx->aoi.pointCount = 1;
+
+    ShmServer server;
+    bool serving = false;
+    if (opts->shmName) {
+        serving = ShmServerOpen(&server, opts->shmName, physCtx, physCtx->slice);
+        if (!serving) {
+            CleanupPhysics(physCtx);
+            dSpaceDestroy(space);
+            return 1;
+        }
+    }
+
+    Fleet fleet = { 0 };
+    if (opts->benchVehicles > 0) {
+        spawnFleet(&fleet, physCtx, opts->benchVehicles,
+                   opts->raycastWheels ? VEHICLE_RAYCAST : VEHICLE_HINGE2);
+        printf("headless: %i %s vehicles\n", fleet.count,
+               opts->raycastWheels ? "raycast" : "hinge2");
+    }
+
+    double start = nowSeconds();
+    double physTime = 0;
+    long step = 0;
+    long ccdClamped = 0;
+
+    while (opts->steps <= 0 || step < opts->steps) {
+        // the controller gets to act before every step
+        if (serving && !ShmServerExchange(&server, physCtx, step)) break;
+
+        double t = nowSeconds();
+        if (fleet.count) driveFleet(&fleet, &physCtx->rng);
+        StepPhysics(physCtx, physCtx->slice);
+        physTime += nowSeconds() - t;
+        ccdClamped += physCtx->ccdClamped;
+
+        ResetFallenObjects(physCtx);
+        step++;
+    }
+
+    double wall = nowSeconds() - start;
+    printf("headless: %li steps (%.2f sim seconds) in %.3f s wall\n",
+                step, step * physCtx->slice, wall);
+    if (step) {
+        printf("headless: physics %.3f ms/step at %i Hz\n", physTime * 1000.0 / step, opts->physicsHz);
+    }
+    // what to pass --seed to get this run again, and what it should end on
+    printf("headless: seed %lu, state hash %08x\n", opts->seed,
+           HashPhysicsState(physCtx, PHYSICS_HASH_START));
+    if (physCtx->aoi.enabled) printf("headless: %.0f%% of bodies active (%i frozen)\n",
+                                     AreaOfInterestActiveFraction(&physCtx->aoi) * 100, physCtx->aoi.frozenCount);
+    if (physCtx->ragdollLod) printf("headless: %i of %i ragdolls collapsed to proxies\n",
+                                    physCtx->ragdollProxies, physCtx->ragdollCount);
+    if (physCtx->ccd) printf("headless: ccd slowed %li fast bodies\n", ccdClamped);
+    const StepMemory* mem = &physCtx->stepMemory;
+    printf("headless: step memory peak %zu KB, peak %i contacts, %i allocations (%i after reserving)\n",
+           mem->peakBlock / 1024, mem->peakContacts, mem->allocs, mem->lateAllocs);
+    MemPrintReport("headless:");
+    if (physCtx->ragdollCount) {
+        MemStats ms;
+        MemGetStats(&ms);
+        printf("headless: %.1f KB per ragdoll\n", (double)ms.live[MEM_RAGDOLLS] / 1024 / physCtx->ragdollCount);
+    }
+
+    if (serving) ShmServerClose(&server);
+    ThawAll(physCtx);
+    freeFleet(&fleet, physCtx);
+    CleanupPhysics(physCtx);
+    dSpaceDestroy(space);
+
+    return 0;
+}
+
+// --bench-contacts, towers of crates dropped a couple of cm apart
+// and left to settle, once with every contact and once reduced
+#define TOWER_HEIGHT 8
+#define CONTACT_BENCH_STEPS (240 * 10)
+
+typedef struct ContactBenchResult {
+    double collideMs;       // per step
+    double solveMs;
+    double joints;          // contact joints per step
+    int toppled;            // towers with a crate more than half a crate from where it started
+    float topDrift;         // mean sideways drift of the top crates
+} ContactBenchResult;
+
+static ContactBenchResult runTowers(int towers, bool reduce)
+{
+    ContactBenchResult res = { 0 };
+    dSpaceID space;
+    PhysicsContext* ctx = CreatePhysicsWorld(&space, 0);
+    if (!ctx) return res;
+    ctx->reduceContacts = reduce;
+    // sleeping towers would hide both the solver cost and any jitter
+    dWorldSetAutoDisableFlag(ctx->world, 0);
+
+    const int count = towers * TOWER_HEIGHT;
+    dBodyID* crates = RL_MALLOC(count * sizeof(dBodyID));
+    Vector3* start = RL_MALLOC(count * sizeof(Vector3));
+    const int perRow = (int)ceilf(sqrtf(towers));
+    for (int t = 0; t < towers; t++) {
+        float x = (t % perRow - (perRow - 1) * 0.5f) * 3;
+        float z = (t / perRow - (perRow - 1) * 0.5f) * 3;
+        for (int h = 0; h < TOWER_HEIGHT; h++) {
+            dBodyID b = dBodyCreate(ctx->world);
+            dGeomID g = dCreateBox(space, 1, 1, 1);
+            dMass m;
+            dMatrix3 R;
+            dMassSetBox(&m, 10, 1, 1, 1);
+            dBodySetMass(b, &m);
+            dGeomSetBody(g, b);
+            dRFromAxisAndAngle(R, 0, 1, 0, (h % 2) * 0.2f);
+            dBodySetRotation(b, R);
+            start[t * TOWER_HEIGHT + h] = (Vector3){ x, 0.52f + h * 1.02f, z };
+            dBodySetPosition(b, x, start[t * TOWER_HEIGHT + h].y, z);
+            crates[t * TOWER_HEIGHT + h] = b;
+        }
+    }
+
+    double collide = 0, solve = 0;
+    long joints = 0;
+    for (int s = 0; s < CONTACT_BENCH_STEPS; s++) {
+        // StepPhysics pulled apart so the solver can be timed on its own
+        double t0 = nowSeconds();
+        ctx->pairCount = 0;
+        ctx->contactCount = 0;
+        ContactCacheBeginStep(&ctx->contacts);
+        TriggerBeginStep(&ctx->triggers);
+        dSpaceCollide(space, ctx, &nearCallback);
+        TriggerEndStep(&ctx->triggers);
+        double t1 = nowSeconds();
+        StepMemoryBegin(&ctx->stepMemory);
+        dWorldQuickStep(ctx->world, PHYS_SLICE);
+        double t2 = nowSeconds();
+        dJointGroupEmpty(ctx->contactgroup);
+        StepMemoryEnd(&ctx->stepMemory, ctx->world, ctx->contactgroup, ctx->contactCount);
+        ctx->stepCount++;
+
+        collide += t1 - t0;
+        solve += t2 - t1;
+        joints += ctx->contactCount;
+    }
+
+    for (int t = 0; t < towers; t++) {
+        bool fell = false;
+        for (int h = 0; h < TOWER_HEIGHT; h++) {
+            const dReal* p = dBodyGetPosition(crates[t * TOWER_HEIGHT + h]);
+            Vector3 s = start[t * TOWER_HEIGHT + h];
+            float drift = sqrtf((p[0] - s.x) * (p[0] - s.x) + (p[2] - s.z) * (p[2] - s.z));
+            if (drift > 0.5f || p[1] < s.y - 0.5f) fell = true;
+            if (h == TOWER_HEIGHT - 1) res.topDrift += drift;
+        }
+        if (fell) res.toppled++;
+    }
+    res.topDrift /= towers;
+    res.collideMs = collide * 1000.0 / CONTACT_BENCH_STEPS;
+    res.solveMs = solve * 1000.0 / CONTACT_BENCH_STEPS;
+    res.joints = (double)joints / CONTACT_BENCH_STEPS;
+
+    RL_FREE(crates);
+    RL_FREE(start);
+    CleanupPhysics(ctx);
+    dSpaceDestroy(space);
+    return res;
+}
+
+int RunContactBench(int towers)
+{
+    printf("contacts: %i towers of %i crates, %i steps\n", towers, TOWER_HEIGHT, CONTACT_BENCH_STEPS);
+    printf("                collide ms  solve ms  joints/step  toppled  top drift\n");
+    for (int reduce = 0; reduce < 2; reduce++) {
+        ContactBenchResult r = runTowers(towers, reduce);
+        printf("  %-12s  %9.3f  %8.3f  %11.1f  %7i  %9.4f\n", reduce ? "reduced" : "all contacts",
+               r.collideMs, r.solveMs, r.joints, r.toppled, r.topDrift);
+    }
+    return 0;
+}
+
+// what drawGeom used to do for each geom
+static void referenceTransforms(const float* positions, const float* rotations,
+                                const Vector3* scales, Matrix* out, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const float* p = &positions[i * 4];
+        Matrix matScale = MatrixScale(scales[i].x, scales[i].y, scales[i].z);
+        Matrix matRot;
+        odeToRayMat(&rotations[i * 12], &matRot);
+        Matrix matTran = MatrixTranslate(p[0], p[1], p[2]);
+        out[i] = MatrixMultiply(MatrixMultiply(matScale, matRot), matTran);
+    }
+}
+
+typedef void (*TransformKernel)(const float*, const float*, const Vector3*, Matrix*, int);
+
+static double timeKernel(TransformKernel kernel, const float* positions, const float* rotations,
+                         const Vector3* scales, Matrix* out, int count, int reps)
+{
+    double start = nowSeconds();
+    for (int r = 0; r < reps; r++) kernel(positions, rotations, scales, out, count);
+    return (nowSeconds() - start) * 1e9 / ((double)reps * count);
+}
+
+static float maxDifference(const Matrix* a, const Matrix* b, int count)
+{
+    float worst = 0;
+    for (int i = 0; i < count; i++) {
+        const float* fa = (const float*)&a[i];
+        const float* fb = (const float*)&b[i];
+        for (int k = 0; k < 16; k++) worst = fmaxf(worst, fabsf(fa[k] - fb[k]));
+    }
+    return worst;
+}
+
+int RunTransformBench(int count)
+{
+    float* positions = RL_MALLOC(count * 4 * sizeof(float));
+    float* rotations = RL_MALLOC(count * 12 * sizeof(float));
+    Vector3* scales = RL_MALLOC(count * sizeof(Vector3));
+    Matrix* ref = RL_MALLOC(count * sizeof(Matrix));
+    Matrix* out = RL_MALLOC(count * sizeof(Matrix));
+
+    for (int i = 0; i < count; i++) {
+        dRFromAxisAndAngle(&rotations[i * 12], rndf(-1, 1), rndf(-1, 1), rndf(-1, 1), rndf(-PI, PI));
+        positions[i * 4 + 0] = rndf(-50, 50);
+        positions[i * 4 + 1] = rndf(0, 10);
+        positions[i * 4 + 2] = rndf(-50, 50);
+        positions[i * 4 + 3] = 0;
+        scales[i] = (Vector3){ rndf(.25, 1), rndf(.25, 1), rndf(.25, 1) };
+    }
+
+    // roughly the same amount of work whatever the count
+    int reps = 20000000 / count;
+    if (reps < 1) reps = 1;
+
+    double refNs = timeKernel(referenceTransforms, positions, rotations, scales, ref, count, reps);
+    double scalarNs = timeKernel(BuildModelMatricesScalar, positions, rotations, scales, out, count, reps);
+    float scalarDiff = maxDifference(ref, out, count);
+    double simdNs = timeKernel(BuildModelMatrices, positions, rotations, scales, out, count, reps);
+    float simdDiff = maxDifference(ref, out, count);
+
+    printf("transforms: %i x %i reps\n", count, reps);
+    printf("  MatrixMultiply path %7.2f ns/matrix\n", refNs);
+    printf("  scalar kernel       %7.2f ns/matrix (%.1fx, max diff %g)\n", scalarNs, refNs / scalarNs, scalarDiff);
+    printf("  batch kernel        %7.2f ns/matrix (%.1fx, max diff %g)\n", simdNs, refNs / simdNs, simdDiff);
+
+    RL_FREE(positions);
+    RL_FREE(rotations);
+    RL_FREE(scales);
+    RL_FREE(ref);
+    RL_FREE(out);
+    return (scalarDiff < 1e-5f && simdDiff < 1e-5f) ? 0 : 1;
+}
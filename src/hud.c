@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "hud.h"
+
+#define HUD_FONT 20
+#define HUD_ROW 20
+#define HUD_GRAPH_HEIGHT 32
+#define HUD_GRAPH_GAP 6
+
+static const char* seriesNames[HUD_SERIES_COUNT] = { "frame ms", "physics ms", "draw ms", "phys steps" };
+static const Color seriesColors[HUD_SERIES_COUNT] = {
+    { 255, 255, 255, 255 }, { 255, 161, 0, 255 }, { 0, 228, 48, 255 }, { 102, 191, 255, 255 }
+};
+
+void InitHud(Hud* hud)
+{
+    memset(hud, 0, sizeof(Hud));
+}
+
+void HudPush(Hud* hud, HudSeriesId id, float value)
+{
+    HudSeries* s = &hud->series[id];
+    s->samples[s->head] = value;
+    s->head = (s->head + 1) % HUD_HISTORY;
+    if (s->count < HUD_HISTORY) s->count++;
+
+    // a few hundred floats, cheaper to rescan than to keep a min/max queue
+    float mn = FLT_MAX, mx = -FLT_MAX, sum = 0;
+    for (int i = 0; i < s->count; i++) {
+        float v = s->samples[i];
+        if (v < mn) mn = v;
+        if (v > mx) mx = v;
+        sum += v;
+    }
+    s->min = mn;
+    s->max = mx;
+    s->avg = sum / s->count;
+}
+
+const char* HudLineText(HudLine* line, const char* fmt, int count, const float* values)
+{
+    float v[4] = { 0 };
+    for (int i = 0; i < count && i < 4; i++) v[i] = values[i];
+    if (!line->valid || memcmp(v, line->values, sizeof(v)) != 0) {
+        memcpy(line->values, v, sizeof(v));
+        line->valid = true;
+        snprintf(line->text, sizeof(line->text), fmt, v[0], v[1], v[2], v[3]);
+    }
+    return line->text;
+}
+
+// shown to 2 places, so anything smaller isn't a change
+static float hundredths(float v)
+{
+    return (int)(v * 100.0f + (v < 0 ? -0.5f : 0.5f)) / 100.0f;
+}
+
+static void graphVertices(const HudSeries* s, Color c, float x, float y, float w, float h)
+{
+    if (s->count < 2) return;
+    // scaled to the window's max, a flat series sits on the baseline
+    float range = (s->max > 0) ? s->max : 1;
+    float dx = w / (HUD_HISTORY - 1);
+    int first = (s->head - s->count + HUD_HISTORY) % HUD_HISTORY;
+    float px = x + (HUD_HISTORY - s->count) * dx;
+    float py = y + h - s->samples[first] / range * h;
+
+    rlColor4ub(c.r, c.g, c.b, c.a);
+    for (int i = 1; i < s->count; i++) {
+        float v = s->samples[(first + i) % HUD_HISTORY];
+        float nx = px + dx;
+        float ny = y + h - v / range * h;
+        rlVertex2f(px, py);
+        rlVertex2f(nx, ny);
+        px = nx;
+        py = ny;
+    }
+}
+
+void DrawHud(Hud* hud, int x, int y)
+{
+    const int graphWidth = HUD_HISTORY;
+    const int textX = x + graphWidth + 10;
+
+    for (int i = 0; i < HUD_SERIES_COUNT; i++) {
+        const HudSeries* s = &hud->series[i];
+        const int gy = y + i * (HUD_GRAPH_HEIGHT + HUD_GRAPH_GAP);
+        const float v[3] = { hundredths(s->min), hundredths(s->avg), hundredths(s->max) };
+        DrawRectangle(x, gy, graphWidth, HUD_GRAPH_HEIGHT, (Color){ 0, 0, 0, 128 });
+        DrawText(seriesNames[i], textX, gy, HUD_FONT / 2, seriesColors[i]);
+        DrawText(HudLineText(&hud->seriesLines[i], "min %.2f avg %.2f max %.2f", 3, v),
+                 textX, gy + HUD_FONT / 2 + 2, HUD_FONT / 2, WHITE);
+    }
+
+    // every sparkline in a single batch of lines
+    rlBegin(RL_LINES);
+    for (int i = 0; i < HUD_SERIES_COUNT; i++) {
+        const int gy = y + i * (HUD_GRAPH_HEIGHT + HUD_GRAPH_GAP);
+        graphVertices(&hud->series[i], seriesColors[i], x, gy, graphWidth, HUD_GRAPH_HEIGHT);
+    }
+    rlEnd();
+
+    const int cy = y + HUD_SERIES_COUNT * (HUD_GRAPH_HEIGHT + HUD_GRAPH_GAP);
+    const float pairs[3] = { hud->counts[HUD_PAIRS], hud->counts[HUD_CACHED], hud->counts[HUD_CONTACTS] };
+    const float bodies[4] = { hud->counts[HUD_AWAKE], hud->counts[HUD_CCD], hud->counts[HUD_ACTIVE_PERCENT],
+                              hud->counts[HUD_DRAW_CALLS] };
+    DrawText(HudLineText(&hud->countLines[0], "pairs %.0f (%.0f cached) contacts %.0f per step", 3, pairs),
+             x, cy, HUD_FONT, WHITE);
+    DrawText(HudLineText(&hud->countLines[1], "awake bodies %.0f (%.0f swept) %.0f%% active, draw calls %.0f", 4, bodies),
+             x, cy + HUD_ROW, HUD_FONT, WHITE);
+    const float memory[4] = { hud->counts[HUD_STEP_MEMORY_KB], hud->counts[HUD_PEAK_CONTACTS],
+                              hud->counts[HUD_RESERVED_CONTACTS], hud->counts[HUD_STEP_ALLOCS] };
+    DrawText(HudLineText(&hud->countLines[2], "step memory %.0f KB, contacts peak %.0f reserved %.0f, late allocs %.0f",
+                         4, memory), x, cy + HUD_ROW * 2, HUD_FONT, WHITE);
+
+    // memory by tag, in KB, for the tags that have been used
+    MemStats ms;
+    MemGetStats(&ms);
+    int my = cy + HUD_ROW * 3;
+    const float total[2] = { ms.liveTotal / 1024, ms.peakTotal / 1024 };
+    DrawText(HudLineText(&hud->memoryLines[0], "memory %.0f KB live %.0f KB peak", 2, total),
+             x, my, HUD_FONT, WHITE);
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        if (!ms.peak[i]) continue;
+        my += HUD_ROW / 2 + 2;
+        const float each = (i == MEM_RAGDOLLS && hud->counts[HUD_RAGDOLLS]) ?
+                           (float)ms.live[i] / 1024 / hud->counts[HUD_RAGDOLLS] : 0;
+        const float v[3] = { ms.live[i] / 1024, ms.peak[i] / 1024, (int)(each * 10) / 10.0f };
+        const char* fmt = each ? "%.0f KB (peak %.0f) %.1f KB each" : "%.0f KB (peak %.0f)";
+        DrawText(MemTagName(i), x + 10, my, HUD_FONT / 2, LIGHTGRAY);
+        DrawText(HudLineText(&hud->memoryLines[i + 1], fmt, 3, v), x + 80, my, HUD_FONT / 2, LIGHTGRAY);
+    }
+}
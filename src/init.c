@@ -31,18 +31,35 @@
 #include "raylibODEvehicle.h"
 #include "raylibODEragdoll.h"
 #include "init.h"
-
-// Helper to allocate geomInfo with collision flag, optional texture, and UV scale
-geomInfo* CreateGeomInfo(bool collidable, Texture* texture, float uvScaleU, float uvScaleV)
+#include "atlas.h"
+#include "assets.h"
+#include "collision.h"
+#include "ccd.h"
+#include "memtrack.h"
+
+// Helper to allocate geomInfo with collision flag, atlas layer (-1 for none), and UV scale
+geomInfo* CreateGeomInfo(PhysicsContext* ctx, bool collidable, int layer, float uvScaleU, float uvScaleV)
 {
-    geomInfo* gi = RL_MALLOC(sizeof(geomInfo));
+    geomInfo* gi = MemAlloc(MEM_GEOMINFO, sizeof(geomInfo));
     gi->collidable = collidable;
-    gi->texture = texture;
+    gi->layer = layer;
     gi->uvScaleU = uvScaleU;
     gi->uvScaleV = uvScaleV;
+    gi->trigger = NULL;
+    gi->shapeCached = false;
+    gi->transformCached = false;
+    // counted per world, so the same seed numbers its geoms the same
+    // way however many worlds the process made before
+    gi->serial = ctx ? ++ctx->geomSerials : 0;
     return gi;
 }
 
+void FreeGeomInfo(dGeomID geom)
+{
+    MemFree(dGeomGetData(geom));
+    dGeomSetData(geom, NULL);
+}
+
 // a lot of this stuff doesn't change too often 
 // so no point polluting main.c with it...
 
@@ -51,34 +68,48 @@ void InitGraphics(GraphicsContext* ctx, int width, int height, const char* title
     InitWindow(width, height, title);
     SetWindowState(FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);
 
+    // decoded up front, from the asset pack when there is one
+    AssetSet assets;
+    if (!LoadAssets(&assets)) {
+        printf("some assets failed to load\n");
+    }
+
     // Load models
     ctx->box = LoadModelFromMesh(GenMeshCube(1, 1, 1));
-    ctx->ball = LoadModelFromMesh(GenMeshSphere(.5, 32, 32));
-    ctx->cylinder = LoadModel("data/cylinder.obj");
-
-    // Load sphere textures
-    ctx->sphereTextures[0] = LoadTexture("data/ball.png");
-    ctx->sphereTextures[1] = LoadTexture("data/beach-ball.png");
-    ctx->sphereTextures[2] = LoadTexture("data/earth.png");
-
-    // Load box textures
-    ctx->boxTextures[0] = LoadTexture("data/crate.png");
-    ctx->boxTextures[1] = LoadTexture("data/grid.png");
-
-    // Load cylinder textures
-    ctx->cylinderTextures[0] = LoadTexture("data/drum.png");
-    ctx->cylinderTextures[1] = LoadTexture("data/cylinder2.png");
+    // lower detail versions are picked by on screen size
+    const int sphereDetail[GEOM_LOD_COUNT] = { 32, 16, 10, 6 };
+    const int cylinderDetail[GEOM_LOD_COUNT] = { 0, 16, 10, 6 };
+    // the decoded mesh is CPU only, GenMesh* upload their own. Without
+    // one there's no level 0, drawGeom uses level 1 for it
+    if (assets.cylinder.vertexCount > 0) {
+        UploadMesh(&assets.cylinder, false);
+        ctx->cylinderLods[0] = LoadModelFromMesh(assets.cylinder);
+    } else {
+        ctx->cylinderLods[0] = (Model){ 0 };
+    }
+    for (int i = 0; i < GEOM_LOD_COUNT; i++) {
+        ctx->ballLods[i] = LoadModelFromMesh(GenMeshSphere(.5, sphereDetail[i], sphereDetail[i]));
+        if (i > 0) ctx->cylinderLods[i] = LoadModelFromMesh(GenMeshCylinder(.5, 1, cylinderDetail[i]));
+    }
+    // GenMeshCylinder goes from y=0 up, ODE cylinders are centred on z
+    ctx->cylinderLodBase = MatrixMultiply(MatrixTranslate(0, -.5, 0), MatrixRotateX(PI / 2));
 
-    // Load ground texture
-    ctx->groundTexture = LoadTexture("data/grass.png");
+    // all the primitive textures are packed into one atlas
+    LoadTextureAtlasFromImage(&ctx->atlas, assets.atlas);
+    if (!IsTextureValid(ctx->atlas.texture)) {
+        printf("texture atlas failed to load, running untextured\n");
+    }
 
-    // Apply default textures to models (overridden by per-instance textures)
-    ctx->box.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->boxTextures[0];
-    ctx->ball.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->sphereTextures[0];
-    ctx->cylinder.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->cylinderTextures[0];
+    // Every model samples the atlas, geomInfo picks the layer
+    ctx->box.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->atlas.texture;
+    for (int i = 0; i < GEOM_LOD_COUNT; i++) {
+        ctx->ballLods[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->atlas.texture;
+        if (!ctx->cylinderLods[i].materialCount) continue;
+        ctx->cylinderLods[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = ctx->atlas.texture;
+    }
 
     // Load shader and set up uniforms
-    ctx->shader = LoadShader("data/simpleLight.vs", "data/simpleLight.fs");
+    ctx->shader = LoadShaderFromMemory(assets.lightVs, assets.lightFs);
     ctx->shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(ctx->shader, "matModel");
     ctx->shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(ctx->shader, "viewPos");
 
@@ -88,35 +119,72 @@ void InitGraphics(GraphicsContext* ctx, int width, int height, const char* title
 
     // Apply shader to models
     ctx->box.materials[0].shader = ctx->shader;
-    ctx->ball.materials[0].shader = ctx->shader;
-    ctx->cylinder.materials[0].shader = ctx->shader;
+    for (int i = 0; i < GEOM_LOD_COUNT; i++) {
+        ctx->ballLods[i].materials[0].shader = ctx->shader;
+        if (ctx->cylinderLods[i].materialCount) ctx->cylinderLods[i].materials[0].shader = ctx->shader;
+    }
 
     // Create lights
     ctx->lights[0] = CreateLight(LIGHT_POINT, (Vector3){-25, 25, 25}, Vector3Zero(),
                                 (Color){128, 128, 128, 255}, ctx->shader);
     ctx->lights[1] = CreateLight(LIGHT_POINT, (Vector3){-25, 25, -25}, Vector3Zero(),
                                 (Color){64, 64, 64, 255}, ctx->shader);
+
+    // specialised shaders for the lights just created
+    InitLighting(&ctx->lighting, assets.lightVs, assets.lightFs);
+    UpdateLighting(&ctx->lighting, ctx->lights, MAX_LIGHTS, ctx->shader);
+
+    UnloadAssets(&assets);
+}
+
+bool EnableClusteredLighting(GraphicsContext* ctx)
+{
+    if (ctx->clusters) return true;
+    ctx->clusters = MemCalloc(MEM_RENDER, 1, sizeof(ClusterLighting));
+    if (!ctx->clusters) return false;
+    if (!InitClusterLighting(ctx->clusters)) {
+        FreeClusterLighting(ctx->clusters);
+        MemFree(ctx->clusters);
+        ctx->clusters = NULL;
+        return false;
+    }
+    ctx->lighting.clustered = true;
+    UpdateLighting(&ctx->lighting, ctx->lights, MAX_LIGHTS, ctx->shader);
+    return true;
 }
 
-PhysicsContext* InitPhysics(dSpaceID* space, GraphicsContext* gfxCtx)
+PhysicsContext* CreatePhysicsWorld(dSpaceID* space, unsigned long seed)
 {
     // Allocate physics context
-    PhysicsContext* ctx = RL_MALLOC(sizeof(PhysicsContext));
+    PhysicsContext* ctx = MemCalloc(MEM_OTHER, 1, sizeof(PhysicsContext));
     if (!ctx) return NULL;
     
     // Initialize arrays to NULL for safe cleanup
     for (int i = 0; i < MAX_RAGDOLLS; i++) {
         ctx->ragdolls[i] = NULL;
     }
+    SeedRng(&ctx->rng, seed, 0);
 
+    MemHookODE();
     dInitODE2(0);
     dAllocateODEDataForThread(dAllocateMaskAll);
 
     ctx->world = dWorldCreate();
     printf("phys iterations per step %i\n", dWorldGetQuickStepNumIterations(ctx->world));
+    MemTag tag = MemSetTag(MEM_SPACES);
     *space = dHashSpaceCreate(NULL);
+    MemSetTag(tag);
     ctx->space = space;  // Store space pointer for cleanup
     ctx->contactgroup = dJointGroupCreate(0);
+    if (!InitContactCache(&ctx->contacts)) {
+        printf("contact cache unavailable, colliding every pair every step\n");
+        FreeContactCache(&ctx->contacts);
+    }
+    ctx->reduceContacts = true;
+    if (!InitAreaOfInterest(&ctx->aoi)) {
+        printf("area of interest unavailable, everything is simulated\n");
+    }
+    InitStepMemory(&ctx->stepMemory, ctx->world);
     dWorldSetGravity(ctx->world, 0, -9.8, 0);
 
     dWorldSetAutoDisableFlag(ctx->world, 1);
@@ -124,40 +192,64 @@ PhysicsContext* InitPhysics(dSpaceID* space, GraphicsContext* gfxCtx)
     dWorldSetAutoDisableAngularThreshold(ctx->world, 0.05);
     dWorldSetAutoDisableSteps(ctx->world, 4);
 
+    // not in any space, only ever used with dSpaceCollide2
+    ctx->queryBox = dCreateBox(0, 1, 1, 1);
+    ctx->querySphere = dCreateSphere(0, 1);
+    ctx->ccdRay = dCreateRay(0, 1);
+    ctx->slice = PHYS_SLICE;
+
     // Create ground "plane"
-    dGeomID planeGeom = dCreateBox(*space, PLANE_SIZE, PLANE_THICKNESS, PLANE_SIZE);
-    dGeomSetPosition(planeGeom, 0, -PLANE_THICKNESS / 2.0, 0);
-    dGeomSetData(planeGeom, CreateGeomInfo(true, &gfxCtx->groundTexture, 25.0f, 25.0f));
+    ctx->ground = dCreateBox(*space, PLANE_SIZE, PLANE_THICKNESS, PLANE_SIZE);
+    dGeomSetPosition(ctx->ground, 0, -PLANE_THICKNESS / 2.0, 0);
+    dGeomSetData(ctx->ground, CreateGeomInfo(ctx, true, ATLAS_GRASS, 25.0f, 25.0f));
+
+    // anything that falls off the plane ends up in here and gets respawned
+    CreateTriggerBox(&ctx->triggers, *space, TRIGGER_KILL, (Vector3){ 0, -KILL_VOLUME_TOP - 50, 0 },
+                        (Vector3){ PLANE_SIZE * 10, 100, PLANE_SIZE * 10 });
+
+    return ctx;
+}
+
+PhysicsContext* InitPhysics(dSpaceID* space, unsigned long seed)
+{
+    PhysicsContext* ctx = CreatePhysicsWorld(space, seed);
+    if (!ctx) return NULL;
 
     // Create random simple objects with random textures
+    Rng* rng = &ctx->rng;
     for (int i = 0; i < NUM_OBJ; i++) {
         ctx->obj[i] = dBodyCreate(ctx->world);
         dGeomID geom;
         dMatrix3 R;
         dMass m;
-        Texture* tex = NULL;
-        float typ = rndf(0, 1);
+        int tex = -1;
+        float typ = RngFloat(rng, 0, 1);
         if (typ < .25) {  // box
-            Vector3 s = (Vector3){rndf(0.25, .5), rndf(0.25, .5), rndf(0.25, .5)};
+            // one at a time, the order arguments and initialisers are
+            // worked out in is up to the compiler
+            Vector3 s;
+            s.x = RngFloat(rng, 0.25, .5);
+            s.y = RngFloat(rng, 0.25, .5);
+            s.z = RngFloat(rng, 0.25, .5);
             geom = dCreateBox(*space, s.x, s.y, s.z);
             dMassSetBox(&m, 10, s.x, s.y, s.z);
             // Random box texture: crate or grid
-            tex = &gfxCtx->boxTextures[(int)rndf(0, 2)];
+            tex = ATLAS_CRATE + RngInt(rng, 2);
         } else if (typ < .5) {  // sphere
-            float r = rndf(0.25, .4);
+            float r = RngFloat(rng, 0.25, .4);
             geom = dCreateSphere(*space, r);
             dMassSetSphere(&m, 10, r);
             // Random sphere texture: ball, beach-ball, or earth
-            tex = &gfxCtx->sphereTextures[(int)rndf(0, 3)];
+            tex = ATLAS_BALL + RngInt(rng, 3);
         } else if (typ < .75) {  // cylinder
-            float l = rndf(0.4, 1);
-            float r = rndf(0.125, .5);
+            float l = RngFloat(rng, 0.4, 1);
+            float r = RngFloat(rng, 0.125, .5);
             geom = dCreateCylinder(*space, r, l);
             dMassSetCylinder(&m, 10, 3, r, l);
             // Random cylinder texture: drum or cylinder2
-            tex = &gfxCtx->cylinderTextures[(int)rndf(0, 2)];
+            tex = ATLAS_DRUM + RngInt(rng, 2);
         } else {  // composite of cylinder with 2 spheres
-            float l = rndf(.25, .5);
+            float l = RngFloat(rng, .25, .5);
             geom = dCreateCylinder(*space, 0.125, l);
             dGeomID geom2 = dCreateSphere(*space, l / 2);
             dGeomID geom3 = dCreateSphere(*space, l / 2);
@@ -177,41 +269,163 @@ PhysicsContext* InitPhysics(dSpaceID* space, GraphicsContext* gfxCtx)
             dGeomSetOffsetPosition(geom3, 0, 0, -l + 0.125);
             
             // Compound objects use cylinder texture
-            tex = &gfxCtx->cylinderTextures[(int)rndf(0, 2)];
+            tex = ATLAS_DRUM + RngInt(rng, 2);
             
-            // Set textures for all geoms in compound object
-            dGeomSetData(geom, CreateGeomInfo(true, tex, 1.0f, 1.0f));
-            dGeomSetData(geom2, CreateGeomInfo(true, tex, 1.0f, 1.0f));
-            dGeomSetData(geom3, CreateGeomInfo(true, tex, 1.0f, 1.0f));
+            // Set textures for the extra geoms, geom gets its own below
+            dGeomSetData(geom2, CreateGeomInfo(ctx, true, tex, 1.0f, 1.0f));
+            dGeomSetData(geom3, CreateGeomInfo(ctx, true, tex, 1.0f, 1.0f));
         }
 
         // Random position and rotation (offset from ragdoll area)
-        dBodySetPosition(ctx->obj[i], dRandReal() * 6 + 5, 4 + (i / 10), dRandReal() * 6 - 3);
-        dRFromAxisAndAngle(R, dRandReal() * 2.0 - 1.0,
-                           dRandReal() * 2.0 - 1.0,
-                           dRandReal() * 2.0 - 1.0,
-                           dRandReal() * M_PI * 2 - M_PI);
+        float x = RngFloat(rng, 5, 11);
+        float z = RngFloat(rng, -3, 3);
+        dBodySetPosition(ctx->obj[i], x, 4 + (i / 10), z);
+        float ax = RngFloat(rng, -1, 1);
+        float ay = RngFloat(rng, -1, 1);
+        float az = RngFloat(rng, -1, 1);
+        dRFromAxisAndAngle(R, ax, ay, az, RngFloat(rng, -M_PI, M_PI));
         dBodySetRotation(ctx->obj[i], R);
         dGeomSetBody(geom, ctx->obj[i]);
         dBodySetMass(ctx->obj[i], &m);
         
         // Set geomInfo with texture
-        dGeomSetData(geom, CreateGeomInfo(true, tex, 1.0f, 1.0f));
+        dGeomSetData(geom, CreateGeomInfo(ctx, true, tex, 1.0f, 1.0f));
     }
 
     // Create ragdolls
     ctx->ragdollCount = MAX_RAGDOLLS;
     for (int i = 0; i < ctx->ragdollCount; i++) {
-        ctx->ragdolls[i] = CreateRagdoll(*space, ctx->world, GetRagdollSpawnPosition(), gfxCtx);
+        ctx->ragdolls[i] = CreateRagdoll(ctx, GetRagdollSpawnPosition(&ctx->rng));
     }
 
     return ctx;
 }
 
+void StepPhysics(PhysicsContext* ctx, float slice)
+{
+    // far cells freeze / thaw and dolls collapse to a proxy or come
+    // back to life before colliding
+    UpdateAreaOfInterest(ctx);
+    if (ctx->ragdollLod) UpdateRagdollLod(ctx);
+
+    // check for collisions (and collect trigger overlaps)
+    ctx->pairCount = 0;
+    ctx->contactCount = 0;
+    ContactCacheBeginStep(&ctx->contacts);
+    TriggerBeginStep(&ctx->triggers);
+    MemTag tag = MemSetTag(MEM_CONTACTS);
+    dSpaceCollide(*ctx->space, ctx, &nearCallback);
+    if (ctx->deterministic) CollideQueuedPairs(ctx);
+    TriggerEndStep(&ctx->triggers);
+    ctx->ccdClamped = ctx->ccd ? ClampFastBodies(ctx, slice) : 0;
+
+    // step the world
+    MemSetTag(MEM_STEP);
+    StepMemoryBegin(&ctx->stepMemory);
+    // quickstep shuffles its constraints with ODE's one global random
+    // generator. dRand itself is atomic so worlds on other threads can
+    // step alongside, but a deterministic run seeds it from this world's
+    // rng first and so has to keep the others out until it's done
+    const bool locked = ctx->deterministic && ctx->stepLock;
+    if (locked) pthread_mutex_lock(ctx->stepLock);
+    if (ctx->deterministic) dRandSetSeed(RngNext(&ctx->rng));
+    dWorldQuickStep(ctx->world, slice);  // NB fixed time step is important
+    if (locked) pthread_mutex_unlock(ctx->stepLock);
+    dJointGroupEmpty(ctx->contactgroup);
+    StepMemoryEnd(&ctx->stepMemory, ctx->world, ctx->contactgroup, ctx->contactCount);
+    MemSetTag(tag);
+
+    for (int i = 0; i < ctx->ragdollCount; i++) {
+        if (ctx->ragdolls[i]) UpdateRagdollAggregates(ctx->ragdolls[i]);
+    }
+    ctx->stepCount++;
+}
+
+int CountAwakeBodies(dSpaceID space)
+{
+    int awake = 0;
+    int ng = dSpaceGetNumGeoms(space);
+    for (int i = 0; i < ng; i++) {
+        dGeomID g = dSpaceGetGeom(space, i);
+        dBodyID b = dGeomGetBody(g);
+        // a body with several geoms only counts at its first
+        if (b && dBodyGetFirstGeom(b) == g && dBodyIsEnabled(b)) awake++;
+    }
+    return awake;
+}
+
+void ResetFallenObjects(PhysicsContext* ctx)
+{
+    // only things that crossed into the kill volume are looked at
+    TriggerEvent ev;
+    while (PollTriggerEvent(&ctx->triggers, &ev)) {
+        if (ev.type != TRIGGER_ENTER || ev.triggerId != TRIGGER_KILL) continue;
+
+        RagDoll* rd = GetBodyRagdoll(ev.body);
+        vehicle* car = GetBodyVehicle(ev.body);
+        if (car) {
+            ResetVehicle(car);
+        } else if (rd) {
+            // Re-create rag doll at a new random spawn position
+            for (int i = 0; i < ctx->ragdollCount; i++) {
+                if (ctx->ragdolls[i] == rd) {
+                    FreeRagdoll(rd, ctx);   // also drops its other parts' queued events and cached contacts
+                    ctx->respawns++;
+                    ctx->ragdolls[i] = CreateRagdoll(ctx, GetRagdollSpawnPosition(&ctx->rng));
+                    break;
+                }
+            }
+        } else {
+            // teleport back if fallen off the ground
+            float x = RngFloat(&ctx->rng, -40, 40);
+            float z = RngFloat(&ctx->rng, -40, 40);
+            dBodySetPosition(ev.body, x, RngFloat(&ctx->rng, 13, 14), z);
+            dBodySetLinearVel(ev.body, 0, 0, 0);
+            dBodySetAngularVel(ev.body, 0, 0, 0);
+            dBodyEnable(ev.body);   // so its cached render transform is refreshed
+        }
+    }
+}
+
+static unsigned int hashBytes(const void* data, size_t size, unsigned int hash)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+static unsigned int hashBody(dBodyID b, unsigned int hash)
+{
+    hash = hashBytes(dBodyGetPosition(b), 3 * sizeof(dReal), hash);
+    hash = hashBytes(dBodyGetQuaternion(b), 4 * sizeof(dReal), hash);
+    hash = hashBytes(dBodyGetLinearVel(b), 3 * sizeof(dReal), hash);
+    return hashBytes(dBodyGetAngularVel(b), 3 * sizeof(dReal), hash);
+}
+
+unsigned int HashPhysicsState(const PhysicsContext* ctx, unsigned int hash)
+{
+    for (int i = 0; i < NUM_OBJ; i++) {
+        if (ctx->obj[i]) hash = hashBody(ctx->obj[i], hash);
+    }
+    for (int i = 0; i < ctx->ragdollCount; i++) {
+        RagDoll* rd = ctx->ragdolls[i];
+        if (!rd) continue;
+        if (rd->proxy) {
+            hash = hashBody(rd->proxy, hash);
+            continue;
+        }
+        for (int j = 0; j < rd->bodyCount; j++) hash = hashBody(rd->bodies[j], hash);
+    }
+    return hash;
+}
+
 void CleanupPhysics(PhysicsContext* ctx)
 {
     if (!ctx) return;
 
+    // frozen geoms go back so everything below finds them
+    ThawAll(ctx);
+
     // Free ragdolls
     for (int i = 0; i < ctx->ragdollCount; i++) {
         if (ctx->ragdolls[i]) {
@@ -219,13 +433,28 @@ void CleanupPhysics(PhysicsContext* ctx)
         }
     }
 
+    // the simple objects and the ground own their geomInfo
+    for (int i = 0; i < NUM_OBJ; i++) {
+        if (!ctx->obj[i]) continue;
+        for (dGeomID g = dBodyGetFirstGeom(ctx->obj[i]); g; g = dBodyGetNextGeom(g)) FreeGeomInfo(g);
+    }
+    if (ctx->ground) FreeGeomInfo(ctx->ground);
+
     // Clean up ODE resources
+    FreeTriggers(&ctx->triggers);
+    FreeContactCache(&ctx->contacts);
+    FreeAreaOfInterest(&ctx->aoi);
+    MemFree(ctx->pairs);
+    dGeomDestroy(ctx->queryBox);
+    dGeomDestroy(ctx->querySphere);
+    MemFree(ctx->fieldQuery);
+    dGeomDestroy(ctx->ccdRay);
     dJointGroupEmpty(ctx->contactgroup);
     dJointGroupDestroy(ctx->contactgroup);
     dWorldDestroy(ctx->world);
     dCloseODE();
 
-    RL_FREE(ctx);
+    MemFree(ctx);
 }
 
 void CleanupGraphics(GraphicsContext* ctx, PhysicsContext* physCtx)
@@ -234,19 +463,26 @@ void CleanupGraphics(GraphicsContext* ctx, PhysicsContext* physCtx)
     CleanupPhysics(physCtx);
 
     // Clean up graphics resources
+    MemFree(ctx->queue.items);
+    MemFree(ctx->queue.pending);
+    MemFree(ctx->queue.positions);
+    MemFree(ctx->queue.rotations);
+    MemFree(ctx->queue.scales);
+    MemFree(ctx->queue.matrices);
+    ctx->queue = (DrawQueue){ 0 };
     UnloadModel(ctx->box);
-    UnloadModel(ctx->ball);
-    UnloadModel(ctx->cylinder);
-    
-    // Unload all textures
-    UnloadTexture(ctx->sphereTextures[0]);
-    UnloadTexture(ctx->sphereTextures[1]);
-    UnloadTexture(ctx->sphereTextures[2]);
-    UnloadTexture(ctx->boxTextures[0]);
-    UnloadTexture(ctx->boxTextures[1]);
-    UnloadTexture(ctx->cylinderTextures[0]);
-    UnloadTexture(ctx->cylinderTextures[1]);
-    UnloadTexture(ctx->groundTexture);
+    for (int i = 0; i < GEOM_LOD_COUNT; i++) {
+        UnloadModel(ctx->ballLods[i]);
+        UnloadModel(ctx->cylinderLods[i]);
+    }
     
+    UnloadTextureAtlas(&ctx->atlas);
+
+    if (ctx->clusters) {
+        FreeClusterLighting(ctx->clusters);
+        MemFree(ctx->clusters);
+        ctx->clusters = NULL;
+    }
+    FreeLighting(&ctx->lighting);
     UnloadShader(ctx->shader);
 }
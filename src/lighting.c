@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "lighting.h"
+#include "clusters.h"
+#include "memtrack.h"
+
+// 2 bits per light slot (0 off, else 1 + type), the variant and clustering above them
+static unsigned int lightingKey(const Light* lights, int count, LightingVariant variant, bool clustered)
+{
+    unsigned int key = 0;
+    for (int i = 0; i < count && i < MAX_LIGHTS; i++) {
+        if (lights[i].enabled) key |= (unsigned int)(1 + lights[i].type) << (i * 2);
+    }
+    key |= (unsigned int)variant << (MAX_LIGHTS * 2);
+    return key | (unsigned int)clustered << (MAX_LIGHTS * 2 + 1);
+}
+
+static bool buildPermutation(LightingCache* cache, LightingShader* ls, unsigned int key,
+                             const Light* lights, int count, LightingVariant variant)
+{
+    char defines[1024];
+    int n = 0;
+    bool any = false;
+    for (int i = 0; i < count && i < MAX_LIGHTS; i++) {
+        if (!lights[i].enabled) continue;
+        n += snprintf(defines + n, sizeof(defines) - n, "#define LIGHT%i_TYPE %i\n", i, lights[i].type);
+        any = true;
+    }
+    if (!any) n += snprintf(defines + n, sizeof(defines) - n, "#define NO_LIGHTS\n");
+    if (variant == LIGHTING_CHEAP) n += snprintf(defines + n, sizeof(defines) - n, "#define CHEAP_LIGHTING\n");
+    if (cache->clustered) {
+        n += snprintf(defines + n, sizeof(defines) - n,
+                      "#define CLUSTERED\n#define CLUSTER_X %i\n#define CLUSTER_Y %i\n#define CLUSTER_Z %i\n"
+                      "#define CLUSTER_INDEX_WIDTH %i\n#define CLUSTER_DEPTH_NEAR %f\n#define CLUSTER_DEPTH_FAR %f\n"
+                      "#define CLUSTER_NEAR_PLANE %f\n#define CLUSTER_FAR_PLANE %f\n",
+                      CLUSTER_X, CLUSTER_Y, CLUSTER_Z, CLUSTER_INDEX_WIDTH, CLUSTER_DEPTH_NEAR, CLUSTER_DEPTH_FAR,
+                      RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    }
+
+    // the defines have to come after the #version line
+    const char* body = strchr(cache->fsSource, '\n');
+    body = body ? body + 1 : cache->fsSource;
+    size_t versionLen = body - cache->fsSource;
+    size_t bodyLen = strlen(body);
+    char* src = RL_MALLOC(versionLen + n + bodyLen + 1);
+    memcpy(src, cache->fsSource, versionLen);
+    memcpy(src + versionLen, defines, n);
+    memcpy(src + versionLen + n, body, bodyLen + 1);
+
+    Shader s = LoadShaderFromMemory(cache->vsSource, src);
+    RL_FREE(src);
+    if (s.id == rlGetShaderIdDefault()) {
+        printf("lighting: permutation %x failed to compile\n", key);
+        return false;
+    }
+
+    s.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(s, "matModel");
+    s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+    int amb = GetShaderLocation(s, "ambient");
+    SetShaderValue(s, amb, (float[4]){0.2, 0.2, 0.2, 1.0}, SHADER_UNIFORM_VEC4);
+
+    ls->key = key;
+    ls->shader = s;
+    ls->texCoordScaleLoc = GetShaderLocation(s, "texCoordScale");
+    ls->atlasRectLoc = GetShaderLocation(s, "atlasRect");
+    ls->screenSizeLoc = -1;
+    if (cache->clustered) {
+        ls->screenSizeLoc = GetShaderLocation(s, "screenSize");
+        const char* samplers[3] = { "clusterGrid", "clusterIndices", "clusterLights" };
+        for (int i = 0; i < 3; i++) {
+            int slot = CLUSTER_TEXTURE_SLOT + i;
+            SetShaderValue(s, GetShaderLocation(s, samplers[i]), &slot, SHADER_UNIFORM_INT);
+        }
+    }
+    return true;
+}
+
+// find or compile, never replacing keep (the other active permutation)
+static LightingShader* getPermutation(LightingCache* cache, const Light* lights, int count,
+                                      LightingVariant variant, const LightingShader* keep)
+{
+    unsigned int key = lightingKey(lights, count, variant, cache->clustered);
+    for (int i = 0; i < cache->count; i++) {
+        if (cache->entries[i].shader.id && cache->entries[i].key == key) return &cache->entries[i];
+    }
+
+    LightingShader* ls;
+    if (cache->count < LIGHTING_CACHE_SIZE) {
+        ls = &cache->entries[cache->count++];
+    } else {
+        if (&cache->entries[cache->next] == keep) cache->next = (cache->next + 1) % LIGHTING_CACHE_SIZE;
+        ls = &cache->entries[cache->next];
+        cache->next = (cache->next + 1) % LIGHTING_CACHE_SIZE;
+        if (ls->shader.id) UnloadShader(ls->shader);
+    }
+    // an empty slot (shader id 0) if the build fails
+    *ls = (LightingShader){ 0 };
+    if (!buildPermutation(cache, ls, key, lights, count, variant)) return &cache->fallback;
+    return ls;
+}
+
+// only the enabled lights exist in a specialised shader and their
+// enabled / type are compile time constants
+static void uploadLights(Shader s, const Light* lights, int count)
+{
+    for (int i = 0; i < count && i < MAX_LIGHTS; i++) {
+        const Light* l = &lights[i];
+        if (!l->enabled) continue;
+        float color[4] = { l->color.r/255.0f, l->color.g/255.0f, l->color.b/255.0f, l->color.a/255.0f };
+        SetShaderValue(s, GetShaderLocation(s, TextFormat("lights[%i].position", i)), &l->position.x, SHADER_UNIFORM_VEC3);
+        SetShaderValue(s, GetShaderLocation(s, TextFormat("lights[%i].target", i)), &l->target.x, SHADER_UNIFORM_VEC3);
+        SetShaderValue(s, GetShaderLocation(s, TextFormat("lights[%i].color", i)), color, SHADER_UNIFORM_VEC4);
+    }
+}
+
+static char* copySource(const char* src)
+{
+    if (!src) return NULL;
+    size_t len = strlen(src) + 1;
+    char* copy = MemAlloc(MEM_ASSETS, len);
+    if (copy) memcpy(copy, src, len);
+    return copy;
+}
+
+bool InitLighting(LightingCache* cache, const char* vsSource, const char* fsSource)
+{
+    cache->vsSource = copySource(vsSource);
+    cache->fsSource = copySource(fsSource);
+    cache->count = 0;
+    cache->next = 0;
+    cache->clustered = false;
+    for (int i = 0; i < LIGHTING_VARIANTS; i++) cache->active[i] = &cache->fallback;
+    return cache->vsSource && cache->fsSource;
+}
+
+void UpdateLighting(LightingCache* cache, const Light* lights, int count, Shader fallback)
+{
+    cache->fallback.key = ~0u;
+    cache->fallback.shader = fallback;
+    cache->fallback.texCoordScaleLoc = GetShaderLocation(fallback, "texCoordScale");
+    cache->fallback.atlasRectLoc = GetShaderLocation(fallback, "atlasRect");
+    cache->fallback.screenSizeLoc = -1;
+
+    if (!cache->vsSource || !cache->fsSource) return;
+
+    cache->active[LIGHTING_FULL] = getPermutation(cache, lights, count, LIGHTING_FULL, NULL);
+    cache->active[LIGHTING_CHEAP] = getPermutation(cache, lights, count, LIGHTING_CHEAP,
+                                                   cache->active[LIGHTING_FULL]);
+    for (int i = 0; i < LIGHTING_VARIANTS; i++) {
+        if (cache->active[i] != &cache->fallback) uploadLights(cache->active[i]->shader, lights, count);
+    }
+}
+
+void SetLightingView(LightingCache* cache, Vector3 viewPos, Vector2 screenSize)
+{
+    Shader f = cache->fallback.shader;
+    SetShaderValue(f, f.locs[SHADER_LOC_VECTOR_VIEW], &viewPos.x, SHADER_UNIFORM_VEC3);
+    for (int i = 0; i < LIGHTING_VARIANTS; i++) {
+        if (cache->active[i] == &cache->fallback) continue;
+        Shader s = cache->active[i]->shader;
+        SetShaderValue(s, s.locs[SHADER_LOC_VECTOR_VIEW], &viewPos.x, SHADER_UNIFORM_VEC3);
+        if (cache->active[i]->screenSizeLoc >= 0) {
+            SetShaderValue(s, cache->active[i]->screenSizeLoc, &screenSize.x, SHADER_UNIFORM_VEC2);
+        }
+    }
+}
+
+void FreeLighting(LightingCache* cache)
+{
+    for (int i = 0; i < cache->count; i++) {
+        if (cache->entries[i].shader.id) UnloadShader(cache->entries[i].shader);
+    }
+    cache->count = 0;
+    MemFree(cache->vsSource);
+    MemFree(cache->fsSource);
+    cache->vsSource = cache->fsSource = NULL;
+}
@@ -31,7 +31,14 @@
 #include "raylibODEvehicle.h"
 #include "raylibODEragdoll.h"
 #include "init.h"
-#include "collision.h"
+#include "options.h"
+#include "headless.h"
+#include "assets.h"
+#include "capture.h"
+#include "hud.h"
+#include "soak.h"
+#include "shard.h"
+#include "forcefield.h"
 
 #include "assert.h"
 
@@ -55,11 +62,69 @@
  * RayLibOdeRagDoll		<-	this project
  */
 
+// --bench-lights, point lights circling about over the plane
+#define LIGHT_BENCH_FRAMES 600
 
-int main(void)
+typedef struct LightBench {
+    Vector3* centres;
+    float* phases;
+    int count;
+} LightBench;
+
+static bool spawnBenchLights(LightBench* bench, GraphicsContext* gfx, int count)
+{
+    if (!EnableClusteredLighting(gfx)) return false;
+    if (count > MAX_POINT_LIGHTS) count = MAX_POINT_LIGHTS;
+    bench->centres = RL_MALLOC(count * sizeof(Vector3));
+    bench->phases = RL_MALLOC(count * sizeof(float));
+    bench->count = count;
+    for (int i = 0; i < count; i++) {
+        bench->centres[i] = (Vector3){ rndf(-PLANE_SIZE/2, PLANE_SIZE/2), rndf(0.5, 3), rndf(-PLANE_SIZE/2, PLANE_SIZE/2) };
+        bench->phases[i] = rndf(0, PI * 2);
+        Color c = ColorFromHSV(rndf(0, 360), 0.8f, 1.0f);
+        AddPointLight(gfx->clusters, bench->centres[i], rndf(4, 10), c);
+    }
+    return true;
+}
+
+static void moveBenchLights(LightBench* bench, ClusterLighting* cl, float t)
+{
+    for (int i = 0; i < bench->count; i++) {
+        float a = t + bench->phases[i];
+        cl->lights[i].position = Vector3Add(bench->centres[i], (Vector3){ cosf(a) * 3, 0, sinf(a) * 3 });
+    }
+}
+
+static void drawScene(GraphicsContext* gfx, Camera camera, PhysicsContext* phys)
+{
+    SetDrawCamera(gfx, camera);
+    gfx->physicsStep = phys->stepCount;
+    BeginMode3D(camera);
+        // NB normally you wouldn't be drawing the collision meshes
+        // instead you'd iterrate all the bodies get a user data pointer
+        // from the body you'd previously set and use that to look up
+        // what you are rendering oriented and positioned as per the
+        // body
+        if (phys->aoi.frozenCount) queueSpaceGeoms(phys->aoi.frozen, gfx);
+        drawAllSpaceGeoms(*phys->space, gfx);
+    EndMode3D();
+}
+
+
+int main(int argc, char** argv)
 {
     assert(sizeof(dReal) == sizeof(float));
-    srand ( time(NULL) );
+
+    AppOptions opts;
+    if (!ParseOptions(&opts, argc, argv)) return 1;
+    if (!opts.seed) opts.seed = time(NULL);
+    srand ( opts.seed );
+    if (opts.packAssets) return PackAssets(ASSET_PACK_FILE) ? 0 : 1;
+    if (opts.benchTransforms > 0) return RunTransformBench(opts.benchTransforms);
+    if (opts.benchContacts > 0) return RunContactBench(opts.benchContacts);
+    if (opts.soakMinutes > 0) return RunSoak(&opts);
+    if (opts.headless && opts.shards > 1) return RunShards(&opts);
+    if (opts.headless) return RunHeadless(&opts);
 
     // Physics context - local to main, holds all physics state
     PhysicsContext* physCtx = NULL;
@@ -86,16 +151,47 @@ int main(void)
     
     DisableCursor();  // Hide and lock cursor
 
-    physCtx = InitPhysics(&space, &graphics);
-
+    physCtx = InitPhysics(&space, opts.seed);
+    physCtx->slice = 1.0f / opts.physicsHz;
+    physCtx->ccd = opts.ccd;
+    physCtx->ragdollLod = opts.ragdollLod;
+    physCtx->aoi.enabled = opts.areaOfInterest;
+    physCtx->aoi.pointCount = 1;    // the camera
+
+
+    LightBench lightBench = { 0 };
+    if (opts.benchLights > 0) {
+        if (!spawnBenchLights(&lightBench, &graphics, opts.benchLights)) {
+            printf("clustered lighting unavailable\n");
+            opts.benchLights = 0;
+        } else {
+            // measure rendering, not the monitor refresh
+            ClearWindowState(FLAG_VSYNC_HINT);
+            SetTargetFPS(0);
+        }
+    }
+    int benchFrame = 0;
+    double benchStart = 0;
+
+    Capture capture = { 0 };
+    if (opts.captureDir) {
+        if (!InitCapture(&capture, opts.captureWidth, opts.captureHeight,
+                         opts.capturePng ? CAPTURE_PNG : CAPTURE_RAW, opts.captureDir)) {
+            opts.captureDir = NULL;
+        }
+    }
 
     Vector3 debug = {0}; // general use
+
+    Hud hud;
+    InitHud(&hud);
+    HudLine overlay[6] = { 0 };     // the text lines above the graphs
     
     // keep the physics fixed time in step with the render frame
     // rate which we don't know in advance
     float frameTime = 0; 
     float physTime = 0;
-    const float physSlice = 1.0 / 240.0;
+    const float physSlice = physCtx->slice;
     const int maxPsteps = 6;
 
     //--------------------------------------------------------------------------------------
@@ -149,85 +245,49 @@ int main(void)
         
         // Update target based on new position
         camera.target = Vector3Add(camera.position, forward);
+        physCtx->lodFocus = camera.position;
+        physCtx->aoi.points[0] = camera.position;
         
         bool spcdn = IsKeyDown(KEY_SPACE);
         
-        for (int i = 0; i < NUM_OBJ; i++) {
-            const dReal* pos = dBodyGetPosition(physCtx->obj[i]);
-            if (spcdn) {
-                // apply force if the space key is held
-                const dReal* v = dBodyGetLinearVel(physCtx->obj[0]);
-                if (v[1] < 10 && pos[1]<10) { // cap upwards velocity and don't let it get too high
-                    dBodyEnable (physCtx->obj[i]); // case its gone to sleep
-                    dMass mass;
-                    dBodyGetMass (physCtx->obj[i], &mass);
-                    // give some object more force than others
-                    float f = (6+(((float)i/NUM_OBJ)*4)) * mass.mass;
-                    dBodyAddForce(physCtx->obj[i], rndf(-f,f), f*10, rndf(-f,f));
-                }
-            }
-
-            
-            if(pos[1]<-10) {
-                // teleport back if fallen off the ground
-                dBodySetPosition(physCtx->obj[i], dRandReal() * 80 - 40,
-                                        12 + rndf(1,2), dRandReal() * 80 - 40);
-                dBodySetLinearVel(physCtx->obj[i], 0, 0, 0);
-                dBodySetAngularVel(physCtx->obj[i], 0, 0, 0);
-            }
-        }
-        
-        // Apply lifting force to ragdolls when space is held
         if (spcdn) {
-            for (int i = 0; i < physCtx->ragdollCount; i++) {
-                if (physCtx->ragdolls[i] && physCtx->ragdolls[i]->bodies[RAGDOLL_HEAD]) {
-                    dBodyEnable(physCtx->ragdolls[i]->bodies[RAGDOLL_HEAD]);
-                    // Calculate total mass of all body parts in the ragdoll
-                    float totalMass = 0.0f;
-                    for (int j = 0; j < physCtx->ragdolls[i]->bodyCount; j++) {
-                        if (physCtx->ragdolls[i]->bodies[j]) {
-                            dMass partMass;
-                            dBodyGetMass(physCtx->ragdolls[i]->bodies[j], &partMass);
-                            totalMass += partMass.mass;
-                        }
-                    }
-                    // Lift force based on total ragdoll mass (60 * total mass)
-                    float liftForce = 60.0f * totalMass;
-                    dBodyAddForce(physCtx->ragdolls[i]->bodies[RAGDOLL_HEAD], 
-                                  rndf(-10, 10), liftForce + rndf(-5, 5), rndf(-10, 10));
-                }
-            }
+            // lift everything near the ground, objects get a random shove
+            // and are capped in height and speed, dolls are lifted whole
+            ForceField lift = { 0 };
+            lift.type = FORCEFIELD_LIFT;
+            lift.targets = FORCEFIELD_OBJECTS;
+            lift.position = (Vector3){ 0, 5, 0 };
+            lift.extents = (Vector3){ PLANE_SIZE / 2, 5, PLANE_SIZE / 2 };
+            lift.strength = 80;
+            lift.jitter = 8;
+            lift.maxSpeed = 10;
+            ApplyForceField(physCtx, &lift);
+
+            lift.targets = FORCEFIELD_RAGDOLLS;
+            lift.position.y = 10;
+            lift.extents.y = 10;
+            lift.strength = 60;
+            lift.jitter = 0.2;
+            lift.maxSpeed = 0;
+            ApplyForceField(physCtx, &lift);
         }
         
-        // Reset rag dolls if they fall off the plane
-        for (int i = 0; i < physCtx->ragdollCount; i++) {
-            if (physCtx->ragdolls[i] && physCtx->ragdolls[i]->bodies[RAGDOLL_TORSO]) {
-                const dReal* pos = dBodyGetPosition(physCtx->ragdolls[i]->bodies[RAGDOLL_TORSO]);
-                if (pos[1] < -10) {
-                    // Re-create rag doll at a new random spawn position
-                    FreeRagdoll(physCtx->ragdolls[i], physCtx);
-                    physCtx->ragdolls[i] = CreateRagdoll(space, physCtx->world, GetRagdollSpawnPosition(), &graphics);
-                }
-            }
-        }
-
+        // teleport / re-create anything that fell off the plane
+        ResetFallenObjects(physCtx);
 
-        if (IsKeyPressed(KEY_L)) { graphics.lights[0].enabled = !graphics.lights[0].enabled; UpdateLightValues(graphics.shader, graphics.lights[0]);}
 
-        // update the light shader with the camera view position
-        SetShaderValue(graphics.shader, graphics.shader.locs[SHADER_LOC_VECTOR_VIEW], &camera.position.x, SHADER_UNIFORM_VEC3);
+        if (IsKeyPressed(KEY_L)) {
+            graphics.lights[0].enabled = !graphics.lights[0].enabled;
+            UpdateLightValues(graphics.shader, graphics.lights[0]);
+            UpdateLighting(&graphics.lighting, graphics.lights, MAX_LIGHTS, graphics.shader);
+        }
 
         frameTime += GetFrameTime();
         int pSteps = 0;
         physTime = GetTime(); 
         
         while (frameTime > physSlice) {
-            // check for collisions
-            dSpaceCollide(space, physCtx, &nearCallback);
-            
-            // step the world
-            dWorldQuickStep(physCtx->world, physSlice);  // NB fixed time step is important
-            dJointGroupEmpty(physCtx->contactgroup);
+            StepPhysics(physCtx, physSlice);
             
             frameTime -= physSlice;
             pSteps++;
@@ -241,40 +301,93 @@ int main(void)
 
 
 
+        if (lightBench.count) moveBenchLights(&lightBench, graphics.clusters, GetTime());
+
         //----------------------------------------------------------------------------------
         // Draw
         //----------------------------------------------------------------------------------
      
+        double drawTime = GetTime();
+        if (opts.captureDir) {
+            BeginCapture(&capture);
+                ClearBackground(BLACK);
+                drawScene(&graphics, camera, physCtx);
+            EndCapture(&capture);
+        }
+
         BeginDrawing();
 
         ClearBackground(BLACK);
 
-        BeginMode3D(camera);
-            // NB normally you wouldn't be drawing the collision meshes
-            // instead you'd iterrate all the bodies get a user data pointer
-            // from the body you'd previously set and use that to look up
-            // what you are rendering oriented and positioned as per the
-            // body
-            drawAllSpaceGeoms(space, &graphics);
-
-
-        EndMode3D();
+        if (opts.captureDir) {
+            // show the capture rather than drawing everything twice
+            // (render textures are upside down)
+            DrawTexturePro(capture.target.texture,
+                           (Rectangle){ 0, 0, capture.width, -capture.height },
+                           (Rectangle){ 0, 0, GetScreenWidth(), GetScreenHeight() },
+                           (Vector2){ 0, 0 }, 0, WHITE);
+        } else {
+            drawScene(&graphics, camera, physCtx);
+        }
+        drawTime = GetTime() - drawTime;
+
+        HudPush(&hud, HUD_FRAME_MS, GetFrameTime() * 1000.0f);
+        HudPush(&hud, HUD_PHYSICS_MS, physTime * 1000.0f);
+        HudPush(&hud, HUD_DRAW_MS, drawTime * 1000.0f);
+        HudPush(&hud, HUD_STEPS, pSteps);
+        hud.counts[HUD_PAIRS] = physCtx->pairCount;
+        hud.counts[HUD_CACHED] = physCtx->contacts.hits;
+        hud.counts[HUD_CONTACTS] = physCtx->contactCount;
+        hud.counts[HUD_AWAKE] = CountAwakeBodies(space);
+        hud.counts[HUD_CCD] = physCtx->ccdClamped;
+        hud.counts[HUD_ACTIVE_PERCENT] = AreaOfInterestActiveFraction(&physCtx->aoi) * 100;
+        hud.counts[HUD_DRAW_CALLS] = graphics.drawCalls;
+        hud.counts[HUD_STEP_MEMORY_KB] = physCtx->stepMemory.peakBlock / 1024;
+        hud.counts[HUD_PEAK_CONTACTS] = physCtx->stepMemory.peakContacts;
+        hud.counts[HUD_RESERVED_CONTACTS] = physCtx->stepMemory.reservedContacts;
+        hud.counts[HUD_STEP_ALLOCS] = physCtx->stepMemory.lateAllocs;
+        hud.counts[HUD_RAGDOLLS] = physCtx->ragdollCount;
 
 
         if (pSteps > maxPsteps) DrawText("WARNING CPU overloaded lagging real time", 10, 0, 20, RED);
-        DrawText(TextFormat("%2i FPS", GetFPS()), 10, 20, 20, WHITE);
+        DrawText(HudLineText(&overlay[0], "%2.0f FPS", 1, (float[]){ GetFPS() }), 10, 20, 20, WHITE);
         DrawText("Rag Doll Physics Demo", 10, 40, 20, WHITE);
         DrawText("Press SPACE to apply force to objects", 10, 60, 20, WHITE);
         DrawText("Vehicle code available for future use", 10, 80, 20, GRAY);
-        DrawText(TextFormat("debug %4.4f %4.4f %4.4f",debug.x,debug.y,debug.z), 10, 100, 20, WHITE);
-        DrawText(TextFormat("Phys steps per frame %i",pSteps), 10, 120, 20, WHITE);
-        DrawText(TextFormat("Phys time per frame %f",physTime), 10, 140, 20, WHITE);
-        DrawText(TextFormat("total time per frame %f",frameTime), 10, 160, 20, WHITE);
-        DrawText(TextFormat("objects %i",NUM_OBJ), 10, 180, 20, WHITE);
-        DrawText(TextFormat("ragdolls %i",physCtx->ragdollCount), 10, 200, 20, WHITE);
+        DrawText(HudLineText(&overlay[1], "debug %4.4f %4.4f %4.4f", 3, &debug.x), 10, 100, 20, WHITE);
+        DrawText(HudLineText(&overlay[2], "objects %.0f ragdolls %.0f (%.0f proxies)", 3,
+                             (float[]){ NUM_OBJ, physCtx->ragdollCount, physCtx->ragdollProxies }),
+                 10, 120, 20, WHITE);
+        DrawText(HudLineText(&overlay[3], "geoms drawn %.0f culled %.0f", 2,
+                             (float[]){ graphics.drawnGeoms, graphics.culledGeoms }), 10, 140, 20, WHITE);
+        int hudY = 160;
+        if (graphics.clusters) {
+            DrawText(HudLineText(&overlay[4], "point lights %.0f cluster entries %.0f", 2,
+                                 (float[]){ graphics.clusters->count, graphics.clusters->indexCount }), 10, hudY, 20, WHITE);
+            hudY += 20;
+        }
+        if (opts.captureDir) {
+            DrawText(HudLineText(&overlay[5], "capture %.0f frames %.0f written %.0f dropped", 3,
+                                 (float[]){ capture.captured, capture.written, capture.dropped }), 10, hudY, 20, RED);
+            hudY += 20;
+        }
+        DrawHud(&hud, 10, hudY + 10);
 
         EndDrawing();
 
+        if (opts.captureFrames > 0 && capture.captured >= opts.captureFrames) break;
+
+        if (opts.benchLights > 0) {
+            // first frame has all the shader compiles and uploads in it
+            if (benchFrame == 0) benchStart = GetTime();
+            if (++benchFrame > LIGHT_BENCH_FRAMES) {
+                double ms = (GetTime() - benchStart) * 1000.0 / LIGHT_BENCH_FRAMES;
+                printf("bench-lights: %i lights, %i cluster entries (%i dropped), %.3f ms/frame\n",
+                       graphics.clusters->count, graphics.clusters->indexCount,
+                       graphics.clusters->overflow, ms);
+                break;
+            }
+        }
     }
     //----------------------------------------------------------------------------------
 
@@ -285,6 +398,9 @@ int main(void)
     //--------------------------------------------------------------------------------------
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    FreeCapture(&capture);
+    RL_FREE(lightBench.centres);
+    RL_FREE(lightBench.phases);
     CleanupGraphics(&graphics, physCtx);
 
     dSpaceDestroy(space);      // Implicitly destroys all geoms (including simple objects)
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "raylib.h"
+#include <ode/ode.h>
+#include "memtrack.h"
+
+// 16 bytes keeps the block as aligned as malloc's
+typedef struct MemHeader {
+    uint32_t tag;
+    uint32_t pad;
+    uint64_t size;
+} MemHeader;
+
+static const char* tagNames[MEM_TAG_COUNT] = {
+    "other", "ode", "geomInfo", "ragdolls", "vehicles", "contacts", "triggers", "spaces", "step", "assets", "render"
+};
+
+// updated from the physics threads too, so everything is atomic
+static size_t live[MEM_TAG_COUNT];
+static size_t peak[MEM_TAG_COUNT];
+static size_t liveTotal;
+static size_t peakTotal;
+static long allocs;
+
+static __thread MemTag currentTag = MEM_ODE;
+
+static void raisePeak(size_t* p, size_t value)
+{
+    size_t old = __atomic_load_n(p, __ATOMIC_RELAXED);
+    while (value > old && !__atomic_compare_exchange_n(p, &old, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+}
+
+static void charge(MemTag tag, long bytes)
+{
+    size_t t = __atomic_add_fetch(&live[tag], (size_t)bytes, __ATOMIC_RELAXED);
+    size_t all = __atomic_add_fetch(&liveTotal, (size_t)bytes, __ATOMIC_RELAXED);
+    if (bytes > 0) {
+        raisePeak(&peak[tag], t);
+        raisePeak(&peakTotal, all);
+    }
+}
+
+void* MemAlloc(MemTag tag, size_t size)
+{
+    MemHeader* h = RL_MALLOC(sizeof(MemHeader) + size);
+    if (!h) return NULL;
+    h->tag = tag;
+    h->size = size;
+    charge(tag, (long)size);
+    __atomic_add_fetch(&allocs, 1, __ATOMIC_RELAXED);
+    return h + 1;
+}
+
+void* MemCalloc(MemTag tag, size_t count, size_t size)
+{
+    void* p = MemAlloc(tag, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+void* MemRealloc(MemTag tag, void* ptr, size_t size)
+{
+    if (!ptr) return MemAlloc(tag, size);
+    MemHeader* old = (MemHeader*)ptr - 1;
+    const MemTag was = (MemTag)old->tag;
+    const size_t oldSize = old->size;
+    MemHeader* h = RL_REALLOC(old, sizeof(MemHeader) + size);
+    if (!h) return NULL;
+    h->size = size;
+    charge(was, (long)size - (long)oldSize);
+    __atomic_add_fetch(&allocs, 1, __ATOMIC_RELAXED);
+    return h + 1;
+}
+
+void MemFree(void* ptr)
+{
+    if (!ptr) return;
+    MemHeader* h = (MemHeader*)ptr - 1;
+    charge((MemTag)h->tag, -(long)h->size);
+    RL_FREE(h);
+}
+
+MemTag MemSetTag(MemTag tag)
+{
+    MemTag prev = currentTag;
+    currentTag = tag;
+    return prev;
+}
+
+static void* odeAlloc(dsizeint size)
+{
+    return MemAlloc(currentTag, size);
+}
+
+static void* odeRealloc(void* ptr, dsizeint oldSize, dsizeint newSize)
+{
+    (void)oldSize;
+    return MemRealloc(currentTag, ptr, newSize);
+}
+
+static void odeFree(void* ptr, dsizeint size)
+{
+    (void)size;
+    MemFree(ptr);
+}
+
+void MemHookODE(void)
+{
+    dSetAllocHandler(odeAlloc);
+    dSetReallocHandler(odeRealloc);
+    dSetFreeHandler(odeFree);
+}
+
+void MemAccount(MemTag tag, long bytes)
+{
+    charge(tag, bytes);
+}
+
+void MemGetStats(MemStats* stats)
+{
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        stats->live[i] = __atomic_load_n(&live[i], __ATOMIC_RELAXED);
+        stats->peak[i] = __atomic_load_n(&peak[i], __ATOMIC_RELAXED);
+    }
+    stats->liveTotal = __atomic_load_n(&liveTotal, __ATOMIC_RELAXED);
+    stats->peakTotal = __atomic_load_n(&peakTotal, __ATOMIC_RELAXED);
+    stats->allocs = __atomic_load_n(&allocs, __ATOMIC_RELAXED);
+}
+
+const char* MemTagName(MemTag tag)
+{
+    return (tag >= 0 && tag < MEM_TAG_COUNT) ? tagNames[tag] : "?";
+}
+
+void MemPrintReport(const char* prefix)
+{
+    MemStats s;
+    MemGetStats(&s);
+    printf("%s memory %zu KB live, %zu KB peak, %li allocations\n",
+           prefix, s.liveTotal / 1024, s.peakTotal / 1024, s.allocs);
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        if (!s.peak[i]) continue;
+        printf("%s   %-9s %9zu KB live %9zu KB peak\n", prefix, tagNames[i], s.live[i] / 1024, s.peak[i] / 1024);
+    }
+}
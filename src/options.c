@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "options.h"
+
+static void printUsage(const char* name)
+{
+    printf("usage: %s [options]\n", name);
+    printf("  --headless          run the physics without a window\n");
+    printf("  --steps N           headless: stop after N physics steps\n");
+    printf("  --shards N          headless: step the scene as N spatial shards in parallel\n");
+    printf("  --workers N         shards: step them on N threads (default one per shard)\n");
+    printf("  --seed N            seed for everything random in the scene (default the clock)\n");
+    printf("  --deterministic     headless: same seed, same result bit for bit, whatever --workers\n");
+    printf("  --shm NAME          headless: serve observations/actions in shm segment NAME\n");
+    printf("  --bench-vehicles N  headless: drive a fleet of N vehicles around the scene\n");
+    printf("  --raycast-wheels    headless: fleet vehicles use raycast wheels\n");
+    printf("  --bench-lights N    add N clustered point lights, time 600 frames and exit\n");
+    printf("  --bench-transforms N  time the model matrix conversion for N transforms and exit\n");
+    printf("  --bench-contacts N  settle N crate towers with and without contact reduction and exit\n");
+    printf("  --pack-assets       write the startup assets to data/assets.pack and exit\n");
+    printf("  --physics-hz N      fixed physics steps per second (default 240)\n");
+    printf("  --aoi               freeze everything further than a couple of cells from the camera\n");
+    printf("  --ragdoll-lod       far away and sleeping ragdolls become one rigid body until needed\n");
+    printf("  --ccd               continuous collision for fast bodies, for running at 60-120 Hz\n");
+    printf("  --soak MINUTES      headless soak test with respawn churn, fails on memory growth or slowdown\n");
+    printf("  --soak-churn N      soak: respawns forced per simulated second (default 4)\n");
+    printf("  --soak-max-growth KB  soak: memory growth allowed (default 4096)\n");
+    printf("  --soak-max-drift PCT  soak: step time drift allowed (default 50)\n");
+    printf("  --capture DIR       record the scene to DIR (raw RGBA frames by default)\n");
+    printf("  --capture-size WxH  capture resolution, default 1280x720\n");
+    printf("  --capture-png       record a png sequence instead\n");
+    printf("  --capture-frames N  exit after N captured frames\n");
+}
+
+bool ParseOptions(AppOptions* opts, int argc, char** argv)
+{
+    opts->headless = false;
+    opts->steps = 0;
+    opts->shards = 0;
+    opts->workers = 0;
+    opts->seed = 0;
+    opts->deterministic = false;
+    opts->shmName = NULL;
+    opts->benchVehicles = 0;
+    opts->raycastWheels = false;
+    opts->benchLights = 0;
+    opts->benchTransforms = 0;
+    opts->benchContacts = 0;
+    opts->packAssets = false;
+    opts->physicsHz = 240;
+    opts->ccd = false;
+    opts->ragdollLod = false;
+    opts->areaOfInterest = false;
+    opts->soakMinutes = 0;
+    opts->soakChurn = 4;
+    opts->soakMaxGrowthKB = 4096;
+    opts->soakMaxDrift = 50;
+    opts->captureDir = NULL;
+    opts->captureWidth = 1280;
+    opts->captureHeight = 720;
+    opts->capturePng = false;
+    opts->captureFrames = 0;
+
+    for (int i = 1; i < argc; i++) {
+        // options taking a value
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--headless") == 0) {
+            opts->headless = true;
+        } else if (strcmp(argv[i], "--steps") == 0 && val) {
+            opts->steps = atol(val);
+            i++;
+        } else if (strcmp(argv[i], "--shards") == 0 && val) {
+            opts->shards = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--workers") == 0 && val) {
+            opts->workers = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--seed") == 0 && val) {
+            opts->seed = strtoul(val, NULL, 0);
+            i++;
+        } else if (strcmp(argv[i], "--deterministic") == 0) {
+            opts->deterministic = true;
+        } else if (strcmp(argv[i], "--shm") == 0 && val) {
+            opts->shmName = val;
+            i++;
+        } else if (strcmp(argv[i], "--bench-vehicles") == 0 && val) {
+            opts->benchVehicles = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--bench-lights") == 0 && val) {
+            opts->benchLights = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--bench-transforms") == 0 && val) {
+            opts->benchTransforms = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--bench-contacts") == 0 && val) {
+            opts->benchContacts = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--raycast-wheels") == 0) {
+            opts->raycastWheels = true;
+        } else if (strcmp(argv[i], "--pack-assets") == 0) {
+            opts->packAssets = true;
+        } else if (strcmp(argv[i], "--physics-hz") == 0 && val && atoi(val) > 0) {
+            opts->physicsHz = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--ccd") == 0) {
+            opts->ccd = true;
+        } else if (strcmp(argv[i], "--aoi") == 0) {
+            opts->areaOfInterest = true;
+        } else if (strcmp(argv[i], "--ragdoll-lod") == 0) {
+            opts->ragdollLod = true;
+        } else if (strcmp(argv[i], "--soak") == 0 && val) {
+            opts->soakMinutes = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--soak-churn") == 0 && val) {
+            opts->soakChurn = atof(val);
+            i++;
+        } else if (strcmp(argv[i], "--soak-max-growth") == 0 && val) {
+            opts->soakMaxGrowthKB = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--soak-max-drift") == 0 && val) {
+            opts->soakMaxDrift = atoi(val);
+            i++;
+        } else if (strcmp(argv[i], "--capture") == 0 && val) {
+            opts->captureDir = val;
+            i++;
+        } else if (strcmp(argv[i], "--capture-size") == 0 && val &&
+                   sscanf(val, "%ix%i", &opts->captureWidth, &opts->captureHeight) == 2 &&
+                   opts->captureWidth > 0 && opts->captureHeight > 0) {
+            i++;
+        } else if (strcmp(argv[i], "--capture-png") == 0) {
+            opts->capturePng = true;
+        } else if (strcmp(argv[i], "--capture-frames") == 0 && val) {
+            opts->captureFrames = atol(val);
+            i++;
+        } else {
+            printf("unknown or incomplete option %s\n", argv[i]);
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // a bare headless run needs something to stop it
+    if (opts->headless && !opts->shmName && opts->steps <= 0) {
+        opts->steps = opts->physicsHz * 60;
+    }
+
+    return true;
+}
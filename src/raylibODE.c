@@ -25,10 +25,15 @@
 #include "raymath.h"
 #include "rlgl.h"
 
+#include <string.h>
+#include <stdint.h>
 #include <ode/ode.h>
 #include "raylibODE.h"
 #include "raylibODEvehicle.h"
 #include "init.h"
+#include "atlas.h"
+#include "xform.h"
+#include "memtrack.h"
 
 // Random float in range [min, max]
 float rndf(float min, float max)
@@ -36,32 +41,45 @@ float rndf(float min, float max)
     return ((float)rand() / (float)(RAND_MAX)) * (max - min) + min;
 }
 
-// optionally a geom can have user data, in this case
-// the only info our user data has is if the geom
-// should collide or not
-// should be pointer to struct which includes render texture and UV scale etc
+struct RagDoll* GetBodyRagdoll(dBodyID body)
+{
+    BodyOwner* o = (BodyOwner*)dBodyGetData(body);
+    return (o && o->type == BODY_OWNER_RAGDOLL) ? (struct RagDoll*)o->owner : NULL;
+}
 
-// position rotation scale all done with the models transform...
-// TODO check there isn't a new raylib function that does this now _pro _ex or similar!
-void MyDrawModel(Model model, Color tint)
+struct vehicle* GetBodyVehicle(dBodyID body)
 {
-    
-    for (int i = 0; i < model.meshCount; i++)
-    {
-        Color color = model.materials[model.meshMaterial[i]].maps[MATERIAL_MAP_DIFFUSE].color;
+    BodyOwner* o = (BodyOwner*)dBodyGetData(body);
+    return (o && o->type == BODY_OWNER_VEHICLE) ? (struct vehicle*)o->owner : NULL;
+}
 
-        Color colorTint = WHITE;
-        colorTint.r = (unsigned char)((((float)color.r/255.0)*((float)tint.r/255.0))*255.0f);
-        colorTint.g = (unsigned char)((((float)color.g/255.0)*((float)tint.g/255.0))*255.0f);
-        colorTint.b = (unsigned char)((((float)color.b/255.0)*((float)tint.b/255.0))*255.0f);
-        colorTint.a = (unsigned char)((((float)color.a/255.0)*((float)tint.a/255.0))*255.0f);
+unsigned int GetBodySerial(dBodyID body)
+{
+    unsigned int serial = 0;
+    for (dGeomID g = dBodyGetFirstGeom(body); g; g = dBodyGetNextGeom(g)) {
+        geomInfo* gi = (geomInfo*)dGeomGetData(g);
+        if (gi && gi->serial && (!serial || gi->serial < serial)) serial = gi->serial;
+    }
+    return serial;
+}
 
-        model.materials[model.meshMaterial[i]].maps[MATERIAL_MAP_DIFFUSE].color = colorTint;
-        DrawMesh(model.meshes[i], model.materials[model.meshMaterial[i]], model.transform);
-        model.materials[model.meshMaterial[i]].maps[MATERIAL_MAP_DIFFUSE].color = color;
+int CompareBodyOrder(dBodyID a, dBodyID b)
+{
+    if (a == b) return 0;
+    const unsigned int sa = GetBodySerial(a), sb = GetBodySerial(b);
+    if (sa != sb) return sa < sb ? -1 : 1;
+    const dReal* pa = dBodyGetPosition(a);
+    const dReal* pb = dBodyGetPosition(b);
+    for (int i = 0; i < 3; i++) {
+        if (pa[i] != pb[i]) return pa[i] < pb[i] ? -1 : 1;
     }
+    return (uintptr_t)a < (uintptr_t)b ? -1 : 1;
 }
 
+// optionally a geom can have user data, in this case
+// the only info our user data has is if the geom
+// should collide or not
+// should be pointer to struct which includes render texture and UV scale etc
 
 // these two just convert to column major and minor
 void rayToOdeMat(Matrix* m, dReal* R) {
@@ -80,64 +98,310 @@ void odeToRayMat(const dReal* R, Matrix* m)
     m->m12 = 0;    m->m13 = 0;    m->m14 = 0;        m->m15 = 1;
 }
 
-// called by draw all geoms
-void drawGeom(dGeomID geom, struct GraphicsContext* ctx) {
-    const dReal* pos = dGeomGetPosition(geom);
-    const dReal* rot = dGeomGetRotation(geom);
+static Vector4 normalizePlane(float a, float b, float c, float d)
+{
+    float l = sqrtf(a*a + b*b + c*c);
+    return (Vector4){ a/l, b/l, c/l, d/l };
+}
+
+void SetDrawCamera(struct GraphicsContext* ctx, Camera camera)
+{
+    // the current target, the window or a render texture
+    const int width = rlGetFramebufferWidth();
+    const int height = rlGetFramebufferHeight();
+    float aspect = (float)width / (float)height;
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix proj = MatrixPerspective(camera.fovy*DEG2RAD, aspect,
+                                    RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    Matrix m = MatrixMultiply(view, proj);
+
+    // Gribb / Hartmann - the planes are sums and differences of the
+    // last row of the view projection matrix with the other three
+    Frustum* f = &ctx->frustum;
+    f->planes[0] = normalizePlane(m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12);    // left
+    f->planes[1] = normalizePlane(m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12);    // right
+    f->planes[2] = normalizePlane(m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13);    // bottom
+    f->planes[3] = normalizePlane(m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13);    // top
+    f->planes[4] = normalizePlane(m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14);   // near
+    f->planes[5] = normalizePlane(m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14);   // far
+
+    SetLightingView(&ctx->lighting, camera.position, (Vector2){ width, height });
+    if (ctx->clusters) UpdateClusterLighting(ctx->clusters, camera, aspect);
+
+    ctx->camera = camera;
+    ctx->pixelsPerUnit = (height * 0.5f) / tanf(camera.fovy*DEG2RAD*0.5f);
+    ctx->drawnGeoms = 0;
+    ctx->culledGeoms = 0;
+    ctx->drawCalls = 0;
+}
+
+static bool sphereInFrustum(const Frustum* f, const dReal* c, float radius)
+{
+    for (int i = 0; i < 6; i++) {
+        const Vector4 p = f->planes[i];
+        if (p.x*c[0] + p.y*c[1] + p.z*c[2] + p.w < -radius) return false;
+    }
+    return true;
+}
+
+// on screen radius (in pixels) picks the detail level
+static int selectLod(const struct GraphicsContext* ctx, const dReal* c, float radius)
+{
+    Vector3 d = { c[0] - ctx->camera.position.x, c[1] - ctx->camera.position.y,
+                  c[2] - ctx->camera.position.z };
+    float dist = Vector3Length(d);
+    if (dist <= radius) return 0;
+    float pixels = radius * ctx->pixelsPerUnit / dist;
+    if (pixels > 60) return 0;
+    if (pixels > 25) return 1;
+    if (pixels > 10) return 2;
+    return 3;
+}
+
+static DrawItem* pushDrawItem(DrawQueue* q)
+{
+    if (q->count == q->capacity) {
+        int capacity = q->capacity ? q->capacity * 2 : 256;
+        DrawItem* items = MemRealloc(MEM_RENDER, q->items, capacity * sizeof(DrawItem));
+        if (!items) return NULL;
+        q->items = items;
+        q->capacity = capacity;
+    }
+    return &q->items[q->count++];
+}
+
+static bool growPending(DrawQueue* q)
+{
+    int capacity = q->pendingCapacity ? q->pendingCapacity * 2 : 256;
+    PendingTransform* pending = MemRealloc(MEM_RENDER, q->pending, capacity * sizeof(PendingTransform));
+    if (pending) q->pending = pending;
+    float* positions = MemRealloc(MEM_RENDER, q->positions, capacity * 4 * sizeof(float));
+    if (positions) q->positions = positions;
+    float* rotations = MemRealloc(MEM_RENDER, q->rotations, capacity * 12 * sizeof(float));
+    if (rotations) q->rotations = rotations;
+    Vector3* scales = MemRealloc(MEM_RENDER, q->scales, capacity * sizeof(Vector3));
+    if (scales) q->scales = scales;
+    Matrix* matrices = MemRealloc(MEM_RENDER, q->matrices, capacity * sizeof(Matrix));
+    if (matrices) q->matrices = matrices;
+    // only take the new size once every array has it
+    if (!pending || !positions || !rotations || !scales || !matrices) return false;
+    q->pendingCapacity = capacity;
+    return true;
+}
+
+// model scale and bounding radius of a geom's unit primitive, false if it isn't drawn
+static bool geomShape(dGeomID geom, Vector3* scale, float* radius)
+{
     int class = dGeomGetClass(geom);
-    Model* m = 0;
+    float capLength = 0;
     dVector3 size;
     if (class == dBoxClass) {
-        m = &ctx->box;
         dGeomBoxGetLengths(geom, size);
     } else if (class == dSphereClass) {
-        m = &ctx->ball;
         float r = dGeomSphereGetRadius(geom);
         size[0] = size[1] = size[2] = (r*2);
     } else if (class == dCylinderClass) {
-        m = &ctx->cylinder;
         dReal l,r;
         dGeomCylinderGetParams (geom, &r, &l);
         size[0] = size[1] = r*2;
         size[2] = l;
     } else if (class == dCapsuleClass) {
-        m = &ctx->cylinder;
         dReal l,r;
         dGeomCapsuleGetParams (geom, &r, &l);
         size[0] = size[1] = r*2;
         size[2] = l;
-	}
-    if (!m) return;
+        capLength = r*2;    // the end caps aren't drawn but still count for culling
+    } else {
+        return false;
+    }
+    *scale = (Vector3){ size[0], size[1], size[2] };
+    // bounding sphere of the (scaled unit) primitive
+    *radius = 0.5f * sqrtf(size[0]*size[0] + size[1]*size[1] +
+                           (size[2]+capLength)*(size[2]+capLength));
+    return true;
+}
 
-    Matrix matScale = MatrixScale(size[0], size[1], size[2]);
-    Matrix matRot;
-    odeToRayMat(rot, &matRot);
-    Matrix matTran = MatrixTranslate(pos[0], pos[1], pos[2]);
+// The shape is cached on first use and the world matrix is only rebuilt
+// when the body could have moved - once per physics step while it's
+// enabled, and once more when it goes to sleep, static geoms never.
+static bool transformIsCurrent(dGeomID geom, const geomInfo* gi, unsigned int step, bool* asleep)
+{
+    dBodyID body = dGeomGetBody(geom);
+    *asleep = body && !dBodyIsEnabled(body);
+    if (!gi || !gi->transformCached) return false;
+    if (!body) return true;
+    if (*asleep && gi->cachedAsleep) return true;
+    return !*asleep && gi->transformStep == step;
+}
 
-    m->transform = MatrixMultiply(MatrixMultiply(matScale, matRot), matTran);
+static Matrix lodTransform(const struct GraphicsContext* ctx, Matrix transform, bool lodBase)
+{
+    return lodBase ? MatrixMultiply(ctx->cylinderLodBase, transform) : transform;
+}
+
+// called by draw all geoms
+void drawGeom(dGeomID geom, struct GraphicsContext* ctx) {
+    int class = dGeomGetClass(geom);
+    Model* m = 0;
+    Model* lods = 0;
+    int layer = -1;     // atlas layer if the geomInfo doesn't give one
+    if (class == dBoxClass) {
+        m = &ctx->box;
+        layer = ATLAS_CRATE;
+    } else if (class == dSphereClass) {
+        lods = ctx->ballLods;
+        layer = ATLAS_BALL;
+    } else if (class == dCylinderClass || class == dCapsuleClass) {
+        lods = ctx->cylinderLods;
+        layer = ATLAS_DRUM;
+    } else {
+        return;
+    }
 
-    // Apply per-instance texture if specified in geomInfo
     geomInfo* gi = (geomInfo*)dGeomGetData(geom);
-    if (gi && gi->texture) {
-        m->materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = *gi->texture;
-        
-        // Apply UV scale for texture tiling
-        Vector2 uvScale = { gi->uvScaleU, gi->uvScaleV };
-        int uvLoc = GetShaderLocation(ctx->shader, "texCoordScale");
-        SetShaderValue(ctx->shader, uvLoc, &uvScale.x, SHADER_UNIFORM_VEC2);
+    Vector3 scale;
+    float radius;
+    if (gi && gi->shapeCached) {
+        scale = gi->scale;
+        radius = gi->boundRadius;
+    } else {
+        if (!geomShape(geom, &scale, &radius)) return;
+        if (gi) {
+            gi->scale = scale;
+            gi->boundRadius = radius;
+            gi->shapeCached = true;
+        }
+    }
+
+    const dReal* pos = dGeomGetPosition(geom);
+    if (!sphereInFrustum(&ctx->frustum, pos, radius)) {
+        ctx->culledGeoms++;
+        return;
+    }
+    ctx->drawnGeoms++;
+
+    // far away things also get the cheaper lighting
+    int lod = selectLod(ctx, pos, radius);
+    if (lods && !lods[lod].meshCount) lod = 1;     // the mesh for level 0 didn't load
+    LightingShader* lighting = ctx->lighting.active[lod >= 2 ? LIGHTING_CHEAP : LIGHTING_FULL];
+    if (lods) {
+        m = &lods[lod];
+    } else {
+        lod = 0;
+    }
+
+    const bool lodBase = lod > 0 && lods == ctx->cylinderLods;
+    bool asleep;
+    const bool current = transformIsCurrent(geom, gi, ctx->physicsStep, &asleep);
+    Matrix transform = current ? lodTransform(ctx, gi->transform, lodBase) : MatrixIdentity();
+
+    // per-instance atlas layer and UV tiling if specified in geomInfo
+    DrawQueue* q = &ctx->queue;
+    const int first = q->count;
+    bool custom = gi && gi->layer >= 0 && gi->layer < ATLAS_LAYER_COUNT;
+    for (int i = 0; i < m->meshCount; i++) {
+        DrawItem* item = pushDrawItem(q);
+        if (!item) break;
+        item->lighting = lighting;
+        item->mesh = &m->meshes[i];
+        item->material = &m->materials[m->meshMaterial[i]];
+        item->layer = custom ? gi->layer : layer;
+        item->uvScale = custom ? (Vector2){ gi->uvScaleU, gi->uvScaleV } : (Vector2){ 1, 1 };
+        item->transform = transform;
     }
-    
-    //dBodyID b = dGeomGetBody(geom);
-    //Color c = WHITE;
-    //if (b) if (!dBodyIsEnabled(b)) c = RED;
-    Color c = WHITE;
+    if (current || q->count == first) return;
 
-    MyDrawModel(*m, c);
-    m->transform = MatrixIdentity();
+    // the matrix itself is built with the rest of the queue's at flush
+    if (q->pendingCount == q->pendingCapacity && !growPending(q)) {
+        BuildModelMatrices(dGeomGetPosition(geom), dGeomGetRotation(geom), &scale, &transform, 1);
+        transform = lodTransform(ctx, transform, lodBase);
+        for (int i = first; i < q->count; i++) q->items[i].transform = transform;
+        return;
+    }
+    const int n = q->pendingCount++;
+    memcpy(&q->positions[n*4], dGeomGetPosition(geom), 4 * sizeof(float));
+    memcpy(&q->rotations[n*12], dGeomGetRotation(geom), 12 * sizeof(float));
+    q->scales[n] = scale;
+    q->pending[n] = (PendingTransform){ gi, first, q->count - first, lodBase, asleep, ctx->physicsStep };
+}
+
+// one batched build for every queued geom that needed a new matrix,
+// then fill in their draw items and transform caches
+static void buildPendingTransforms(struct GraphicsContext* ctx)
+{
+    DrawQueue* q = &ctx->queue;
+    if (!q->pendingCount) return;
+    BuildModelMatrices(q->positions, q->rotations, q->scales, q->matrices, q->pendingCount);
+    for (int i = 0; i < q->pendingCount; i++) {
+        const PendingTransform* p = &q->pending[i];
+        if (p->gi) {
+            p->gi->transform = q->matrices[i];
+            p->gi->transformStep = p->step;
+            p->gi->cachedAsleep = p->asleep;
+            p->gi->transformCached = true;
+        }
+        Matrix transform = lodTransform(ctx, q->matrices[i], p->lodBase);
+        for (int j = 0; j < p->itemCount; j++) q->items[p->firstItem + j].transform = transform;
+    }
+    q->pendingCount = 0;
+}
+
+// shader, then mesh, then atlas layer, then UV scale - the texture
+// is always the atlas so only uniforms change between meshes
+static int compareDrawItems(const void* a, const void* b)
+{
+    const DrawItem* ia = (const DrawItem*)a;
+    const DrawItem* ib = (const DrawItem*)b;
+    if (ia->lighting->shader.id != ib->lighting->shader.id)
+        return ia->lighting->shader.id < ib->lighting->shader.id ? -1 : 1;
+    if (ia->mesh != ib->mesh) return ia->mesh < ib->mesh ? -1 : 1;
+    if (ia->layer != ib->layer) return ia->layer - ib->layer;
+    if (ia->uvScale.x != ib->uvScale.x) return ia->uvScale.x < ib->uvScale.x ? -1 : 1;
+    if (ia->uvScale.y != ib->uvScale.y) return ia->uvScale.y < ib->uvScale.y ? -1 : 1;
+    return 0;
+}
+
+void FlushGeomQueue(struct GraphicsContext* ctx)
+{
+    DrawQueue* q = &ctx->queue;
+    buildPendingTransforms(ctx);
+    qsort(q->items, q->count, sizeof(DrawItem), compareDrawItems);
+    if (ctx->clusters) BindClusterLighting(ctx->clusters);
+
+    // only upload the UV scale and atlas rect when they change,
+    // uniforms belong to the program so a new shader starts over
+    LightingShader* lighting = NULL;
+    bool uvValid = false;
+    Vector2 uvScale = { 0 };
+    int layer = -1;
+    for (int i = 0; i < q->count; i++) {
+        DrawItem* item = &q->items[i];
+        if (item->lighting != lighting) {
+            lighting = item->lighting;
+            uvValid = false;
+            layer = -1;
+        }
+        Shader s = lighting->shader;
+        if (!uvValid || item->uvScale.x != uvScale.x || item->uvScale.y != uvScale.y) {
+            uvScale = item->uvScale;
+            uvValid = true;
+            SetShaderValue(s, lighting->texCoordScaleLoc, &uvScale.x, SHADER_UNIFORM_VEC2);
+        }
+        if (item->layer != layer) {
+            layer = item->layer;
+            SetShaderValue(s, lighting->atlasRectLoc, &ctx->atlas.rects[layer].x, SHADER_UNIFORM_VEC4);
+        }
+        Material material = *item->material;
+        material.shader = s;
+        DrawMesh(*item->mesh, material, item->transform);
+    }
+    ctx->drawCalls += q->count;
+    q->count = 0;
 }
 
 // draw all the geoms in a space
-void drawAllSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx) {
+void queueSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx)
+{
     int ng = dSpaceGetNumGeoms(space);
     for (int i=0; i<ng; i++) {
         dGeomID geom = dSpaceGetGeom(space, i);
@@ -148,3 +412,8 @@ void drawAllSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx) {
         }
     }
 }
+
+void drawAllSpaceGeoms(dSpaceID space, struct GraphicsContext* ctx) {
+    queueSpaceGeoms(space, ctx);
+    FlushGeomQueue(ctx);
+}
@@ -21,6 +21,8 @@
  *
  */
 
+#include <string.h>
+
 #include "raylib.h"
 #include "raymath.h"
 
@@ -28,33 +30,76 @@
 #include "raylibODE.h"
 #include "raylibODEragdoll.h"
 #include "init.h"
+#include "atlas.h"
+#include "memtrack.h"
 
 // Get a spawn position within the defined ragdoll spawn volume
-Vector3 GetRagdollSpawnPosition(void)
+Vector3 GetRagdollSpawnPosition(Rng* rng)
 {
     Vector3 pos;
-    pos.x = rndf(RAGDOLL_SPAWN_CENTER_X - RAGDOLL_SPAWN_HALF_EXTENT, RAGDOLL_SPAWN_CENTER_X + RAGDOLL_SPAWN_HALF_EXTENT);
-    pos.y = rndf(RAGDOLL_SPAWN_MIN_Y, RAGDOLL_SPAWN_MAX_Y);
-    pos.z = rndf(RAGDOLL_SPAWN_CENTER_Z - RAGDOLL_SPAWN_HALF_EXTENT, RAGDOLL_SPAWN_CENTER_Z + RAGDOLL_SPAWN_HALF_EXTENT);
+    pos.x = RngFloat(rng, RAGDOLL_SPAWN_CENTER_X - RAGDOLL_SPAWN_HALF_EXTENT, RAGDOLL_SPAWN_CENTER_X + RAGDOLL_SPAWN_HALF_EXTENT);
+    pos.y = RngFloat(rng, RAGDOLL_SPAWN_MIN_Y, RAGDOLL_SPAWN_MAX_Y);
+    pos.z = RngFloat(rng, RAGDOLL_SPAWN_CENTER_Z - RAGDOLL_SPAWN_HALF_EXTENT, RAGDOLL_SPAWN_CENTER_Z + RAGDOLL_SPAWN_HALF_EXTENT);
     return pos;
 }
 
 
+// while the doll is still in its spawn pose, everything relative to the torso
+static void captureRest(RagDoll *ragdoll)
+{
+    RagdollRest* rest = ragdoll->rest;
+    const dReal* t = dBodyGetPosition(ragdoll->bodies[RAGDOLL_TORSO]);
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        const dReal* p = dBodyGetPosition(ragdoll->bodies[i]);
+        for (int k = 0; k < 3; k++) rest->position[i][k] = p[k] - t[k];
+    }
+    for (int i = 0; i < ragdoll->jointCount; i++) {
+        dJointID j = ragdoll->joints[i];
+        RagdollJointRest* jr = &rest->joints[i];
+        if (dJointGetType(j) == dJointTypeHinge) {
+            dJointGetHingeAnchor(j, jr->anchor);
+            dJointGetHingeAxis(j, jr->axis1);
+            jr->stops[0] = dJointGetHingeParam(j, dParamLoStop);
+            jr->stops[1] = dJointGetHingeParam(j, dParamHiStop);
+        } else {
+            dJointGetUniversalAnchor(j, jr->anchor);
+            dJointGetUniversalAxis1(j, jr->axis1);
+            dJointGetUniversalAxis2(j, jr->axis2);
+            jr->stops[0] = dJointGetUniversalParam(j, dParamLoStop);
+            jr->stops[1] = dJointGetUniversalParam(j, dParamHiStop);
+            jr->stops[2] = dJointGetUniversalParam(j, dParamLoStop2);
+            jr->stops[3] = dJointGetUniversalParam(j, dParamHiStop2);
+        }
+        for (int k = 0; k < 3; k++) jr->anchor[k] -= t[k];
+    }
+}
+
 // Rag doll creation - generic structure for eventual neural network muscle control
 // Creates a humanoid rag doll with configurable joint motors
 // actually way more complex than the vehicle stuff !
-RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct GraphicsContext* ctx)
+RagDoll* CreateRagdoll(PhysicsContext *ctx, Vector3 position)
 {
-    RagDoll *ragdoll = RL_MALLOC(sizeof(RagDoll));
+    dSpaceID space = *ctx->space;
+    dWorldID world = ctx->world;
+
+    // the doll's ODE bodies, geoms and joints are charged to it too
+    MemTag tag = MemSetTag(MEM_RAGDOLLS);
+    RagDoll *ragdoll = MemAlloc(MEM_RAGDOLLS, sizeof(RagDoll));
     ragdoll->bodyCount = RAGDOLL_BODY_COUNT;
-    ragdoll->jointCount = 9;  // neck, shoulders, elbows, hips, knees
+    ragdoll->jointCount = RAGDOLL_JOINT_COUNT;
     ragdoll->motorCount = 0;  // No motors initially, can be added for neural network control
 
     // Allocate arrays for bodies, geoms, joints, and motors
-    ragdoll->bodies = RL_MALLOC(ragdoll->bodyCount * sizeof(dBodyID));
-    ragdoll->geoms = RL_MALLOC(ragdoll->bodyCount * sizeof(dGeomID));
-    ragdoll->joints = RL_MALLOC(ragdoll->jointCount * sizeof(dJointID));
-    ragdoll->motors = RL_MALLOC(ragdoll->jointCount * sizeof(dJointID));  // Potential motors
+    ragdoll->bodies = MemAlloc(MEM_RAGDOLLS, ragdoll->bodyCount * sizeof(dBodyID));
+    ragdoll->geoms = MemAlloc(MEM_RAGDOLLS, ragdoll->bodyCount * sizeof(dGeomID));
+    ragdoll->joints = MemAlloc(MEM_RAGDOLLS, ragdoll->jointCount * sizeof(dJointID));
+    ragdoll->motors = MemAlloc(MEM_RAGDOLLS, ragdoll->jointCount * sizeof(dJointID));  // Potential motors
+    ragdoll->masses = MemAlloc(MEM_RAGDOLLS, ragdoll->bodyCount * sizeof(float));
+    ragdoll->parts = MemAlloc(MEM_RAGDOLLS, ragdoll->bodyCount * sizeof(RagdollPart));
+    ragdoll->proxy = NULL;
+    ragdoll->lodHit = false;
+    ragdoll->lodHold = 0;
+    ragdoll->rest = MemAlloc(MEM_RAGDOLLS, sizeof(RagdollRest));
 
     dMass m;
 
@@ -70,9 +115,9 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     float legRadius = 0.12f;
 
     // Ragdoll specific textures (consistent across all ragdolls)
-    Texture* headTex = &ctx->sphereTextures[1];        // beach-ball.png
-    Texture* torsoTex = &ctx->boxTextures[0];         // crate.png
-    Texture* limbTex = &ctx->cylinderTextures[1];     // cylinder2.png
+    int headTex = ATLAS_BEACH_BALL;
+    int torsoTex = ATLAS_CRATE;
+    int limbTex = ATLAS_CYLINDER;
 
     // Create head
     dMassSetSphere(&m, 1, headRadius);
@@ -83,7 +128,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
                      position.x, position.y + 1.6f, position.z);
     ragdoll->geoms[RAGDOLL_HEAD] = dCreateSphere(space, headRadius);
     dGeomSetBody(ragdoll->geoms[RAGDOLL_HEAD], ragdoll->bodies[RAGDOLL_HEAD]);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_HEAD], CreateGeomInfo(true, headTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_HEAD], CreateGeomInfo(ctx, true, headTex, 1.0f, 1.0f));
 
     // Create torso
     dMassSetBox(&m, 1, torsoWidth, torsoHeight, torsoDepth);
@@ -94,7 +139,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
                      position.x, position.y + 0.9f, position.z);
     ragdoll->geoms[RAGDOLL_TORSO] = dCreateBox(space, torsoWidth, torsoHeight, torsoDepth);
     dGeomSetBody(ragdoll->geoms[RAGDOLL_TORSO], ragdoll->bodies[RAGDOLL_TORSO]);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_TORSO], CreateGeomInfo(true, torsoTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_TORSO], CreateGeomInfo(ctx, true, torsoTex, 1.0f, 1.0f));
 
     // Create arms - initialize mass for each individually
     // ODE cylinders are along Z-axis by default
@@ -114,7 +159,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_LEFT_UPPER_ARM], R_arm);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_LEFT_UPPER_ARM],
                      position.x - 0.35f, position.y + 1.1f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_UPPER_ARM], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_UPPER_ARM], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Left lower arm
     dMassSetCylinder(&m, 1, 3, armRadius, armLength);
@@ -127,7 +172,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_LEFT_LOWER_ARM], R_arm);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_LEFT_LOWER_ARM],
                      position.x - 0.35f - armLength, position.y + 1.1f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_LOWER_ARM], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_LOWER_ARM], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Right upper arm
     dMassSetCylinder(&m, 1, 3, armRadius, armLength);
@@ -140,7 +185,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_ARM], R_arm);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_RIGHT_UPPER_ARM],
                      position.x + 0.35f, position.y + 1.1f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_ARM], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_ARM], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Right lower arm
     dMassSetCylinder(&m, 1, 3, armRadius, armLength);
@@ -153,7 +198,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_ARM], R_arm);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_RIGHT_LOWER_ARM],
                      position.x + 0.35f + armLength, position.y + 1.1f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_ARM], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_ARM], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Create legs - initialize mass for each individually
     // ODE cylinders are along Z-axis by default
@@ -172,7 +217,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_LEFT_UPPER_LEG], R_leg);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_LEFT_UPPER_LEG],
                      position.x - 0.15f, position.y + 0.45f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_UPPER_LEG], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_UPPER_LEG], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Left lower leg
     dMassSetCylinder(&m, 1, 3, legRadius, legLength);
@@ -185,7 +230,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_LEFT_LOWER_LEG], R_leg);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_LEFT_LOWER_LEG],
                      position.x - 0.15f, position.y, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_LOWER_LEG], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_LEFT_LOWER_LEG], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Right upper leg
     dMassSetCylinder(&m, 1, 3, legRadius, legLength);
@@ -198,7 +243,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_LEG], R_leg);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_RIGHT_UPPER_LEG],
                      position.x + 0.15f, position.y + 0.45f, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_LEG], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_UPPER_LEG], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Right lower leg
     dMassSetCylinder(&m, 1, 3, legRadius, legLength);
@@ -211,7 +256,7 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dGeomSetOffsetWorldRotation(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_LEG], R_leg);
     dBodySetPosition(ragdoll->bodies[RAGDOLL_RIGHT_LOWER_LEG],
                      position.x + 0.15f, position.y, position.z);
-    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_LEG], CreateGeomInfo(true, limbTex, 1.0f, 1.0f));
+    dGeomSetData(ragdoll->geoms[RAGDOLL_RIGHT_LOWER_LEG], CreateGeomInfo(ctx, true, limbTex, 1.0f, 1.0f));
 
     // Create joints connecting body parts
 
@@ -311,9 +356,365 @@ RagDoll* CreateRagdoll(dSpaceID space, dWorldID world, Vector3 position, struct
     dJointSetHingeParam(ragdoll->joints[8], dParamLoStop, 0.0f);        // Can't bend forward
     dJointSetHingeParam(ragdoll->joints[8], dParamHiStop, 2.5f);        // Max bend ~143 degrees
 
+    // body user data points back at the doll so contacts and queries
+    // can find the whole ragdoll from any of its parts
+    ragdoll->owner.type = BODY_OWNER_RAGDOLL;
+    ragdoll->owner.owner = ragdoll;
+    ragdoll->totalMass = 0;
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dBodySetData(ragdoll->bodies[i], &ragdoll->owner);
+        dBodyGetMass(ragdoll->bodies[i], &m);
+        ragdoll->masses[i] = m.mass;
+        ragdoll->totalMass += m.mass;
+    }
+    captureRest(ragdoll);
+    ragdoll->enabled = false;   // forces the first update
+    UpdateRagdollAggregates(ragdoll);
+
+    MemSetTag(tag);
     return ragdoll;
 }
 
+// a = b * c for ODE's padded 3x4 rotations
+static void multiplyRotation(dReal* a, const dReal* b, const dReal* c)
+{
+    for (int r = 0; r < 3; r++) {
+        for (int k = 0; k < 3; k++) {
+            a[r*4 + k] = b[r*4] * c[k] + b[r*4 + 1] * c[4 + k] + b[r*4 + 2] * c[8 + k];
+        }
+        a[r*4 + 3] = 0;
+    }
+}
+
+// put the parts where the proxy says they are, moving with it, so
+// anything reading the bodies sees the doll even while collapsed
+static void followProxy(RagDoll *ragdoll)
+{
+    const dReal* R = dBodyGetRotation(ragdoll->proxy);
+    const dReal* w = dBodyGetAngularVel(ragdoll->proxy);
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        const RagdollPart* part = &ragdoll->parts[i];
+        dBodyID b = ragdoll->bodies[i];
+        dVector3 p, v;
+        dMatrix3 rot;
+        dBodyGetRelPointPos(ragdoll->proxy, part->position[0], part->position[1], part->position[2], p);
+        dBodyGetPointVel(ragdoll->proxy, p[0], p[1], p[2], v);
+        multiplyRotation(rot, R, part->rotation);
+        dBodySetPosition(b, p[0], p[1], p[2]);
+        dBodySetRotation(b, rot);
+        dBodySetLinearVel(b, v[0], v[1], v[2]);
+        dBodySetAngularVel(b, w[0], w[1], w[2]);
+    }
+}
+
+void CollapseRagdoll(RagDoll *ragdoll, PhysicsContext *ctx)
+{
+    if (ragdoll->proxy) return;
+    MemTag tag = MemSetTag(MEM_RAGDOLLS);
+
+    // the parts' masses summed in world space, and their momentum
+    dMass total, m;
+    dMassSetZero(&total);
+    dVector3 momentum = { 0, 0, 0 }, spin = { 0, 0, 0 };
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dBodyID b = ragdoll->bodies[i];
+        const dReal* p = dBodyGetPosition(b);
+        const dReal* v = dBodyGetLinearVel(b);
+        const dReal* w = dBodyGetAngularVel(b);
+        dBodyGetMass(b, &m);
+        dMassRotate(&m, dBodyGetRotation(b));
+        dMassTranslate(&m, p[0], p[1], p[2]);
+        dMassAdd(&total, &m);
+        for (int k = 0; k < 3; k++) {
+            momentum[k] += v[k] * ragdoll->masses[i];
+            // near enough for a doll that's far off or settling
+            spin[k] += w[k] * ragdoll->masses[i];
+        }
+    }
+    // bodies want their centre of mass at the origin
+    const dVector3 com = { total.c[0], total.c[1], total.c[2] };
+    dMassTranslate(&total, -com[0], -com[1], -com[2]);
+    total.c[0] = total.c[1] = total.c[2] = 0;
+
+    // starts unrotated, so part poses relative to it are just offsets
+    dBodyID proxy = dBodyCreate(ctx->world);
+    dBodySetMass(proxy, &total);
+    dBodySetPosition(proxy, com[0], com[1], com[2]);
+    dBodySetLinearVel(proxy, momentum[0] / total.mass, momentum[1] / total.mass, momentum[2] / total.mass);
+    dBodySetAngularVel(proxy, spin[0] / total.mass, spin[1] / total.mass, spin[2] / total.mass);
+    dBodySetData(proxy, &ragdoll->owner);
+
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        RagdollPart* part = &ragdoll->parts[i];
+        dBodyID b = ragdoll->bodies[i];
+        dGeomID g = ragdoll->geoms[i];
+        const dReal* p = dBodyGetPosition(b);
+        for (int k = 0; k < 3; k++) part->position[k] = p[k] - com[k];
+        memcpy(part->rotation, dBodyGetRotation(b), sizeof(dMatrix3));
+
+        // moving the geom to another body drops its offset
+        part->geomOffset = dGeomIsOffset(g);
+        if (part->geomOffset) {
+            memcpy(part->geomPosition, dGeomGetOffsetPosition(g), sizeof(dVector3));
+            memcpy(part->geomRotation, dGeomGetOffsetRotation(g), sizeof(dMatrix3));
+        }
+        dVector3 gp;
+        dMatrix3 gr;
+        memcpy(gp, dGeomGetPosition(g), sizeof(dVector3));
+        memcpy(gr, dGeomGetRotation(g), sizeof(dMatrix3));
+        dGeomSetBody(g, proxy);
+        dGeomSetOffsetWorldPosition(g, gp[0], gp[1], gp[2]);
+        dGeomSetOffsetWorldRotation(g, gr);
+
+        ThawBody(ctx, b);
+        TriggerForgetBody(&ctx->triggers, b);
+        dBodyDisable(b);
+    }
+    for (int i = 0; i < ragdoll->jointCount; i++) {
+        dJointDisable(ragdoll->joints[i]);
+    }
+
+    if (!ragdoll->enabled) dBodyDisable(proxy);
+    ragdoll->proxy = proxy;
+    ragdoll->lodHit = false;
+    MemSetTag(tag);
+}
+
+void PromoteRagdoll(RagDoll *ragdoll, PhysicsContext *ctx)
+{
+    if (!ragdoll->proxy) return;
+    ThawBody(ctx, ragdoll->proxy);
+
+    // the parts pick up the proxy's pose and motion, then take their
+    // geoms back with the offsets they had
+    followProxy(ragdoll);
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        const RagdollPart* part = &ragdoll->parts[i];
+        dGeomID g = ragdoll->geoms[i];
+        dGeomSetBody(g, ragdoll->bodies[i]);
+        if (part->geomOffset) {
+            dGeomSetOffsetPosition(g, part->geomPosition[0], part->geomPosition[1], part->geomPosition[2]);
+            dGeomSetOffsetRotation(g, part->geomRotation);
+        }
+        dBodyEnable(ragdoll->bodies[i]);
+    }
+    for (int i = 0; i < ragdoll->jointCount; i++) {
+        dJointEnable(ragdoll->joints[i]);
+    }
+
+    TriggerForgetBody(&ctx->triggers, ragdoll->proxy);
+    dBodyDestroy(ragdoll->proxy);
+    ragdoll->proxy = NULL;
+    ragdoll->enabled = true;
+    ragdoll->lodHit = false;
+    ragdoll->lodHold = RAGDOLL_LOD_HOLD;
+}
+
+void UpdateRagdollLod(PhysicsContext *ctx)
+{
+    int proxies = 0;
+    for (int i = 0; i < ctx->ragdollCount; i++) {
+        RagDoll* rd = ctx->ragdolls[i];
+        // frozen dolls are left as they are until thawed
+        if (!rd || dGeomGetSpace(rd->geoms[0]) != *ctx->space) continue;
+        const float dist = Vector3Distance(rd->centerOfMass, ctx->lodFocus);
+
+        if (rd->proxy) {
+            if (rd->lodHit || (rd->enabled && dist < RAGDOLL_LOD_NEAR)) {
+                PromoteRagdoll(rd, ctx);
+            }
+        } else if (rd->lodHold > 0) {
+            rd->lodHold--;
+        } else if (!rd->enabled || dist > RAGDOLL_LOD_FAR) {
+            CollapseRagdoll(rd, ctx);
+        }
+        rd->lodHit = false;
+        if (rd->proxy) proxies++;
+    }
+    ctx->ragdollProxies = proxies;
+}
+
+void NoteRagdollContact(dBodyID b1, dBodyID b2)
+{
+    if (!b1 || !b2) return;     // resting on the ground isn't a hit
+    RagDoll* r1 = GetBodyRagdoll(b1);
+    RagDoll* r2 = GetBodyRagdoll(b2);
+    if (!(r1 && r1->proxy == b1) && !(r2 && r2->proxy == b2)) return;
+
+    const dReal* v1 = dBodyGetLinearVel(b1);
+    const dReal* v2 = dBodyGetLinearVel(b2);
+    const float dv[3] = { v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2] };
+    if (dv[0]*dv[0] + dv[1]*dv[1] + dv[2]*dv[2] < RAGDOLL_LOD_HIT_SPEED * RAGDOLL_LOD_HIT_SPEED) return;
+    if (r1 && r1->proxy == b1) r1->lodHit = true;
+    if (r2 && r2->proxy == b2) r2->lodHit = true;
+}
+
+// r * v for ODE's padded 3x4 rotations
+static void rotateVector(dReal* out, const dReal* r, const dReal* v)
+{
+    for (int k = 0; k < 3; k++) out[k] = r[k*4] * v[0] + r[k*4 + 1] * v[1] + r[k*4 + 2] * v[2];
+}
+
+// ODE bodies and joints can't change worlds, so the doll is built again
+// in the new one. The joints have to be made with the parts in the rest
+// pose (turned to the torso's heading) or their zero angles and limits
+// would be wherever the doll happened to be bent, after that every part
+// gets its real pose and motion back.
+void MoveRagdoll(RagDoll *ragdoll, PhysicsContext *from, PhysicsContext *to)
+{
+    // the parts have to be real bodies to be rebuilt, the LOD collapses
+    // it again in the new world if it's still far off or asleep
+    PromoteRagdoll(ragdoll, from);
+    MemTag tag = MemSetTag(MEM_RAGDOLLS);
+    const RagdollRest* rest = ragdoll->rest;
+
+    dVector3 torso;
+    dMatrix3 R;
+    memcpy(torso, dBodyGetPosition(ragdoll->bodies[RAGDOLL_TORSO]), sizeof(dVector3));
+    memcpy(R, dBodyGetRotation(ragdoll->bodies[RAGDOLL_TORSO]), sizeof(dMatrix3));
+
+    dBodyID bodies[RAGDOLL_BODY_COUNT];
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dMass m;
+        dVector3 p;
+        dBodyGetMass(ragdoll->bodies[i], &m);
+        bodies[i] = dBodyCreate(to->world);
+        dBodySetMass(bodies[i], &m);
+        rotateVector(p, R, rest->position[i]);
+        dBodySetPosition(bodies[i], torso[0] + p[0], torso[1] + p[1], torso[2] + p[2]);
+        dBodySetRotation(bodies[i], R);
+        dBodySetData(bodies[i], &ragdoll->owner);
+    }
+
+    for (int i = 0; i < ragdoll->jointCount; i++) {
+        dJointID old = ragdoll->joints[i];
+        const RagdollJointRest* jr = &rest->joints[i];
+        int b0 = 0, b1 = 0;
+        for (int k = 0; k < ragdoll->bodyCount; k++) {
+            if (ragdoll->bodies[k] == dJointGetBody(old, 0)) b0 = k;
+            if (ragdoll->bodies[k] == dJointGetBody(old, 1)) b1 = k;
+        }
+        dVector3 a, x1, x2;
+        rotateVector(a, R, jr->anchor);
+        rotateVector(x1, R, jr->axis1);
+        rotateVector(x2, R, jr->axis2);
+        for (int k = 0; k < 3; k++) a[k] += torso[k];
+
+        dJointID j;
+        if (dJointGetType(old) == dJointTypeHinge) {
+            j = dJointCreateHinge(to->world, 0);
+            dJointAttach(j, bodies[b0], bodies[b1]);
+            dJointSetHingeAnchor(j, a[0], a[1], a[2]);
+            dJointSetHingeAxis(j, x1[0], x1[1], x1[2]);
+            dJointSetHingeParam(j, dParamLoStop, jr->stops[0]);
+            dJointSetHingeParam(j, dParamHiStop, jr->stops[1]);
+        } else {
+            j = dJointCreateUniversal(to->world, 0);
+            dJointAttach(j, bodies[b0], bodies[b1]);
+            dJointSetUniversalAnchor(j, a[0], a[1], a[2]);
+            dJointSetUniversalAxis1(j, x1[0], x1[1], x1[2]);
+            dJointSetUniversalAxis2(j, x2[0], x2[1], x2[2]);
+            dJointSetUniversalParam(j, dParamLoStop, jr->stops[0]);
+            dJointSetUniversalParam(j, dParamHiStop, jr->stops[1]);
+            dJointSetUniversalParam(j, dParamLoStop2, jr->stops[2]);
+            dJointSetUniversalParam(j, dParamHiStop2, jr->stops[3]);
+        }
+        dJointDestroy(old);
+        ragdoll->joints[i] = j;
+    }
+
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dBodyID old = ragdoll->bodies[i];
+        dBodyID b = bodies[i];
+        ThawBody(from, old);
+        const dReal* p = dBodyGetPosition(old);
+        const dReal* v = dBodyGetLinearVel(old);
+        const dReal* w = dBodyGetAngularVel(old);
+        dBodySetPosition(b, p[0], p[1], p[2]);
+        dBodySetQuaternion(b, dBodyGetQuaternion(old));
+        dBodySetLinearVel(b, v[0], v[1], v[2]);
+        dBodySetAngularVel(b, w[0], w[1], w[2]);
+        if (!dBodyIsEnabled(old)) dBodyDisable(b);
+
+        // the geom loses its offset changing body
+        dGeomID g = ragdoll->geoms[i];
+        const bool offset = dGeomIsOffset(g);
+        dVector3 op;
+        dMatrix3 orot;
+        if (offset) {
+            memcpy(op, dGeomGetOffsetPosition(g), sizeof(dVector3));
+            memcpy(orot, dGeomGetOffsetRotation(g), sizeof(dMatrix3));
+        }
+        dGeomSetBody(g, b);
+        if (offset) {
+            dGeomSetOffsetPosition(g, op[0], op[1], op[2]);
+            dGeomSetOffsetRotation(g, orot);
+        }
+        ContactCacheForgetGeom(&from->contacts, g);
+        dSpaceRemove(*from->space, g);
+        dSpaceAdd(*to->space, g);
+
+        TriggerForgetBody(&from->triggers, old);
+        dBodyDestroy(old);
+        ragdoll->bodies[i] = b;
+    }
+
+    MemSetTag(tag);
+}
+
+void UpdateRagdollAggregates(RagDoll *ragdoll)
+{
+    bool enabled = false;
+    if (ragdoll->proxy) {
+        enabled = dBodyIsEnabled(ragdoll->proxy);
+        if (enabled) followProxy(ragdoll);
+    }
+    for (int i = 0; i < ragdoll->bodyCount && !enabled; i++) {
+        enabled = dBodyIsEnabled(ragdoll->bodies[i]);
+    }
+    // nothing moves while asleep, so only the first step after
+    // the doll dozes off needs to refresh the cache
+    bool wasEnabled = ragdoll->enabled;
+    ragdoll->enabled = enabled;
+    if (!enabled && !wasEnabled) return;
+
+    Vector3 com = { 0 };
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        const dReal* p = dBodyGetPosition(ragdoll->bodies[i]);
+        com.x += p[0] * ragdoll->masses[i];
+        com.y += p[1] * ragdoll->masses[i];
+        com.z += p[2] * ragdoll->masses[i];
+    }
+    com = Vector3Scale(com, 1.0f / ragdoll->totalMass);
+
+    // sphere around the COM enclosing every part's AABB
+    float radius = 0;
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dReal aabb[6];
+        dGeomGetAABB(ragdoll->geoms[i], aabb);
+        Vector3 half = { (aabb[1] - aabb[0]) * 0.5f, (aabb[3] - aabb[2]) * 0.5f, (aabb[5] - aabb[4]) * 0.5f };
+        Vector3 centre = { aabb[0] + half.x, aabb[2] + half.y, aabb[4] + half.z };
+        float r = Vector3Distance(com, centre) + Vector3Length(half);
+        if (r > radius) radius = r;
+    }
+
+    ragdoll->centerOfMass = com;
+    ragdoll->boundRadius = radius;
+}
+
+void EnableRagdoll(RagDoll *ragdoll)
+{
+    if (ragdoll->proxy) {
+        dBodyEnable(ragdoll->proxy);
+        ragdoll->enabled = true;
+        return;
+    }
+    for (int i = 0; i < ragdoll->bodyCount; i++) {
+        dBodyEnable(ragdoll->bodies[i]);
+    }
+    ragdoll->enabled = true;
+}
+
 // Update rag doll motors with neural network control values
 // motorForces array should have one value per joint for control
 void UpdateRagdollMotors(RagDoll *ragdoll, float *motorForces)
@@ -361,9 +762,11 @@ void FreeRagdoll(RagDoll *ragdoll, PhysicsContext *ctx)
     if (ragdoll->bodies) {
         for (int i = 0; i < ragdoll->bodyCount; i++) {
             if (ragdoll->bodies[i]) {
+                ThawBody(ctx, ragdoll->bodies[i]);
+                TriggerForgetBody(&ctx->triggers, ragdoll->bodies[i]);
                 // Remove geom from space before destroying body
-                if (ragdoll->geoms && ragdoll->geoms[i] && ctx->space) {
-                    dSpaceRemove(*ctx->space, ragdoll->geoms[i]);
+                if (ragdoll->geoms && ragdoll->geoms[i] && dGeomGetSpace(ragdoll->geoms[i])) {
+                    dSpaceRemove(dGeomGetSpace(ragdoll->geoms[i]), ragdoll->geoms[i]);
                 }
                 dBodyDestroy(ragdoll->bodies[i]);
             }
@@ -374,11 +777,20 @@ void FreeRagdoll(RagDoll *ragdoll, PhysicsContext *ctx)
     if (ragdoll->geoms) {
         for (int i = 0; i < ragdoll->bodyCount; i++) {
             if (ragdoll->geoms[i]) {
+                ContactCacheForgetGeom(&ctx->contacts, ragdoll->geoms[i]);
+                FreeGeomInfo(ragdoll->geoms[i]);
                 dGeomDestroy(ragdoll->geoms[i]);
             }
         }
     }
 
+    // the geoms are gone so the proxy has nothing left on it
+    if (ragdoll->proxy) {
+        ThawBody(ctx, ragdoll->proxy);
+        TriggerForgetBody(&ctx->triggers, ragdoll->proxy);
+        dBodyDestroy(ragdoll->proxy);
+    }
+
     // Destroy ODE joints (indexed by jointCount)
     if (ragdoll->joints) {
         for (int i = 0; i < ragdoll->jointCount; i++) {
@@ -398,10 +810,13 @@ void FreeRagdoll(RagDoll *ragdoll, PhysicsContext *ctx)
     }
 
     // Free wrapper arrays
-    if (ragdoll->bodies) RL_FREE(ragdoll->bodies);
-    if (ragdoll->geoms) RL_FREE(ragdoll->geoms);
-    if (ragdoll->joints) RL_FREE(ragdoll->joints);
-    if (ragdoll->motors) RL_FREE(ragdoll->motors);
-
-    RL_FREE(ragdoll);
+    MemFree(ragdoll->bodies);
+    MemFree(ragdoll->geoms);
+    MemFree(ragdoll->joints);
+    MemFree(ragdoll->motors);
+    MemFree(ragdoll->masses);
+    MemFree(ragdoll->parts);
+    MemFree(ragdoll->rest);
+
+    MemFree(ragdoll);
 }
@@ -27,25 +27,135 @@
 #include <ode/ode.h>
 #include "raylibODE.h"
 #include "raylibODEvehicle.h"
+#include "memtrack.h"
 
 
-// reused for all geoms that don't collide
-// ie vehicle counter weights
-static geomInfo disabled;
+VehicleDesc DefaultVehicleDesc(void)
+{
+    VehicleDesc d;
+    d.model = VEHICLE_HINGE2;
+    d.chassisSize = (Vector3){2.5, 0.5, 2.0};
+    d.chassisMass = 150;
+    d.wheelRadius = 0.5;
+    d.wheelWidth = 0.45;
+    d.wheelMass = 2;
+    d.axleOffset = 1.2;
+    d.trackOffset = 1;
+    d.wheelDrop = 0.5;
+    d.counterWeightDrop = 2;
+    d.motorForce = 1500;
+    d.steerForce = 500;
+    d.steerLimit = 0.5;
+    d.springRate = 4000;
+    d.damping = 400;
+    d.tireGrip = 1.2;
+    d.rollInfluence = 0.6;
+    return d;
+}
+
+// wheel i (0-3) position relative to the chassis, front pair first
+static void wheelOffset(const VehicleDesc* d, int i, dReal* o)
+{
+    o[0] = (i < 2) ? d->axleOffset : -d->axleOffset;
+    o[1] = -d->wheelDrop;
+    o[2] = ((i % 2) == 0) ? -d->trackOffset : d->trackOffset;
+}
 
+// place all the bodies upright around the chassis position p
+static void placeVehicle(vehicle* car, Vector3 p)
+{
+    dMatrix3 R;
+    dRSetIdentity(R);
+    dBodySetPosition(car->bodies[0], p.x, p.y, p.z);
+    dBodySetRotation(car->bodies[0], R);
+    if (car->desc.model == VEHICLE_RAYCAST) return;
+
+    dBodySetPosition(car->bodies[5], p.x, p.y - car->desc.counterWeightDrop, p.z);
+    dBodySetRotation(car->bodies[5], R);
+
+    dQuaternion q;
+    dQFromAxisAndAngle(q, 0, 0, 1, M_PI * 0.5);
+    for (int i = 0; i < 4; i++) {
+        dReal o[3];
+        wheelOffset(&car->desc, i, o);
+        dBodySetPosition(car->bodies[i+1], p.x + o[0], p.y + o[1], p.z + o[2]);
+        dBodySetQuaternion(car->bodies[i+1], q);
+    }
+}
 
-vehicle* CreateVehicle(dSpaceID space, dWorldID world)
+// chassis body plus four rays, no wheel bodies or joints at all
+static void createRaycastVehicle(vehicle* car, dSpaceID space, dWorldID world)
 {
-    // TODO these should be parameters
-    Vector3 carScale = (Vector3){2.5, 0.5, 2.0};
-    float wheelRadius = 0.5, wheelWidth = 0.45;
+    const VehicleDesc* desc = &car->desc;
+    Vector3 carScale = desc->chassisSize;
+
+    // the wheels' mass is carried by the chassis
+    dMass m;
+    dMassSetBox(&m, 1, carScale.x, carScale.y, carScale.z);
+    dMassAdjust(&m, desc->chassisMass + desc->wheelMass * 4);
+
+    car->bodies[0] = dBodyCreate(world);
+    dBodySetMass(car->bodies[0], &m);
+    dBodySetAutoDisableFlag( car->bodies[0], 0 );
+    dBodySetData(car->bodies[0], &car->owner);
+
+    car->geoms[0] = dCreateBox(space, carScale.x, carScale.y, carScale.z);
+    dGeomSetBody(car->geoms[0], car->bodies[0]);
+
+    car->cab = dCreateBox(space, 0.5, 0.5, 0.5);
+    dGeomSetBody(car->cab, car->bodies[0]);
+    dGeomSetOffsetPosition(car->cab, carScale.x/2-0.25, carScale.y/2+0.25 , 0);
 
-    vehicle* car = RL_MALLOC(sizeof(vehicle));
+    // rays aren't in the space, they're only ever collided with dSpaceCollide2
+    for (int i = 1; i <= 4; i++) {
+        car->geoms[i] = dCreateRay(0, desc->wheelDrop + desc->wheelRadius);
+        dGeomSetData(car->geoms[i], &car->noCollide);
+        car->bodies[i] = NULL;
+        car->joints[i-1] = NULL;
+    }
+    car->bodies[5] = NULL;
+    car->geoms[5] = NULL;
+    car->joints[4] = car->joints[5] = NULL;
+}
+
+vehicle* CreateVehicle(dSpaceID space, dWorldID world, Vector3 position, const VehicleDesc* desc)
+{
+    MemTag tag = MemSetTag(MEM_VEHICLES);
+    // zeroed, the hinge2 car has no joints[4] and FreeVehicle destroys
+    // whatever isn't NULL
+    vehicle* car = MemCalloc(MEM_VEHICLES, 1, sizeof(vehicle));
+    if (!car) {
+        MemSetTag(tag);
+        return NULL;
+    }
+    car->desc = desc ? *desc : DefaultVehicleDesc();
+    car->space = space;
+    car->spawn = position;
+    car->steerAngle = 0;
+    car->slice = PHYS_SLICE;
+    for (int i = 0; i < 4; i++) car->compression[i] = 0;
+    car->lastAccel = NAN;       // first update always sends the motor params
+    desc = &car->desc;
+    Vector3 carScale = desc->chassisSize;
+
+    // every body points back at the car, the counter weight
+    // has its own (per vehicle) non colliding user data
+    car->owner.type = BODY_OWNER_VEHICLE;
+    car->owner.owner = car;
+    car->noCollide = (geomInfo){ 0 };
+    car->noCollide.collidable = false;
+
+    if (desc->model == VEHICLE_RAYCAST) {
+        createRaycastVehicle(car, space, world);
+        placeVehicle(car, position);
+        MemSetTag(tag);
+        return car;
+    }
 
     // car body
     dMass m;
     dMassSetBox(&m, 1, carScale.x, carScale.y, carScale.z);  // density
-    dMassAdjust(&m, 150); // mass
+    dMassAdjust(&m, desc->chassisMass); // mass
 
     car->bodies[0] = dBodyCreate(world);
     dBodySetMass(car->bodies[0], &m);
@@ -55,49 +165,40 @@ vehicle* CreateVehicle(dSpaceID space, dWorldID world)
     car->geoms[0] = dCreateBox(space, carScale.x, carScale.y, carScale.z);
     dGeomSetBody(car->geoms[0], car->bodies[0]);
 
-    // TODO used a little later and should be a parameter
-    dBodySetPosition(car->bodies[0], 15, 6, 15.5);
-
-    dGeomID front = dCreateBox(space, 0.5, 0.5, 0.5);
-    dGeomSetBody(front, car->bodies[0]);
-    dGeomSetOffsetPosition(front, carScale.x/2-0.25, carScale.y/2+0.25 , 0);
+    car->cab = dCreateBox(space, 0.5, 0.5, 0.5);
+    dGeomSetBody(car->cab, car->bodies[0]);
+    dGeomSetOffsetPosition(car->cab, carScale.x/2-0.25, carScale.y/2+0.25 , 0);
 
     car->bodies[5] = dBodyCreate(world);
     dBodySetMass(car->bodies[5], &m);
     dBodySetAutoDisableFlag( car->bodies[5], 0 );
-    // see previous TODO
-    dBodySetPosition(car->bodies[5], 15, 6-2, 15.5);
     car->geoms[5] = dCreateSphere(space,1);
     dGeomSetBody(car->geoms[5],car->bodies[5]);
-    disabled.collidable = false;
-    dGeomSetData(car->geoms[5], &disabled);
-
-    car->joints[5] = dJointCreateFixed (world, 0);
-    dJointAttach(car->joints[5], car->bodies[0], car->bodies[5]);
-    dJointSetFixed (car->joints[5]);
+    dGeomSetData(car->geoms[5], &car->noCollide);
 
     // wheels
-    dMassSetCylinder(&m, 1, 3, wheelRadius, wheelWidth);
-    dMassAdjust(&m, 2); // mass
-    dQuaternion q;
-    dQFromAxisAndAngle(q, 0, 0, 1, M_PI * 0.5);
+    dMassSetCylinder(&m, 1, 3, desc->wheelRadius, desc->wheelWidth);
+    dMassAdjust(&m, desc->wheelMass); // mass
     for(int i = 1; i <= 4; ++i)
     {
         car->bodies[i] = dBodyCreate(world);
         dBodySetMass(car->bodies[i], &m);
-        dBodySetQuaternion(car->bodies[i], q);
-        car->geoms[i] = dCreateCylinder(space, wheelRadius, wheelWidth);
+        car->geoms[i] = dCreateCylinder(space, desc->wheelRadius, desc->wheelWidth);
         dGeomSetBody(car->geoms[i], car->bodies[i]);
         dBodySetFiniteRotationMode( car->bodies[i], 1 );
             dBodySetAutoDisableFlag( car->bodies[i], 0 );
     }
 
-    const dReal* cp = dBodyGetPosition(car->bodies[0]);
-    // TODO wheel base and axel width should be parameters
-    dBodySetPosition(car->bodies[1], cp[0]+1.2, cp[1]-.5, cp[2]-1);
-    dBodySetPosition(car->bodies[2], cp[0]+1.2, cp[1]-.5, cp[2]+1);
-    dBodySetPosition(car->bodies[3], cp[0]-1.2, cp[1]-.5, cp[2]-1);
-    dBodySetPosition(car->bodies[4], cp[0]-1.2, cp[1]-.5, cp[2]+1);
+    for (int i = 0; i < 6; i++) {
+        dBodySetData(car->bodies[i], &car->owner);
+    }
+
+    // bodies must be in place before the joints are anchored
+    placeVehicle(car, position);
+
+    car->joints[5] = dJointCreateFixed (world, 0);
+    dJointAttach(car->joints[5], car->bodies[0], car->bodies[5]);
+    dJointSetFixed (car->joints[5]);
 
     // hinge2 (combined steering / suspension / motor !)
     for(int i = 0; i < 4; ++i)
@@ -119,21 +220,21 @@ vehicle* CreateVehicle(dSpaceID space, dWorldID world)
         dJointSetHinge2Param(car->joints[i], dParamHiStop, 0);
         dJointSetHinge2Param(car->joints[i], dParamLoStop, 0);
         dJointSetHinge2Param(car->joints[i], dParamHiStop, 0);
-        dJointSetHinge2Param(car->joints[i], dParamFMax, 1500);
+        dJointSetHinge2Param(car->joints[i], dParamFMax, desc->motorForce);
 
         dJointSetHinge2Param(car->joints[i], dParamVel2, dInfinity);
-        dJointSetHinge2Param(car->joints[i], dParamFMax2, 1500);
+        dJointSetHinge2Param(car->joints[i], dParamFMax2, desc->motorForce);
 
         dJointSetHinge2Param(car->joints[i], dParamSuspensionERP, 0.9);
         dJointSetHinge2Param(car->joints[i], dParamSuspensionCFM, 0.002);
 
         // steering
         if (i<2) {
-            dJointSetHinge2Param (car->joints[i],dParamFMax,500);
-            dJointSetHinge2Param (car->joints[i],dParamLoStop,-0.5);
-            dJointSetHinge2Param (car->joints[i],dParamHiStop,0.5);
-            dJointSetHinge2Param (car->joints[i],dParamLoStop,-0.5);
-            dJointSetHinge2Param (car->joints[i],dParamHiStop,0.5);
+            dJointSetHinge2Param (car->joints[i],dParamFMax,desc->steerForce);
+            dJointSetHinge2Param (car->joints[i],dParamLoStop,-desc->steerLimit);
+            dJointSetHinge2Param (car->joints[i],dParamHiStop,desc->steerLimit);
+            dJointSetHinge2Param (car->joints[i],dParamLoStop,-desc->steerLimit);
+            dJointSetHinge2Param (car->joints[i],dParamHiStop,desc->steerLimit);
             dJointSetHinge2Param (car->joints[i],dParamFudgeFactor,0.1);
         }
 
@@ -142,13 +243,134 @@ vehicle* CreateVehicle(dSpaceID space, dWorldID world)
     dJointSetHinge2Param(car->joints[0], dParamFMax2, 0);
     dJointSetHinge2Param(car->joints[1], dParamFMax2, 0);
 
+    MemSetTag(tag);
     return car;
 }
 
 
+typedef struct WheelHit {
+    dGeomID ray;
+    dBodyID self;
+    float dist;
+    dVector3 pos;
+    dVector3 normal;
+} WheelHit;
+
+// nearest thing along a wheel ray, ignoring our own chassis
+static void wheelRayCallback(void *data, dGeomID o1, dGeomID o2)
+{
+    WheelHit* hit = (WheelHit*)data;
+    dGeomID g = (o1 == hit->ray) ? o2 : o1;
+
+    if (hit->self && dGeomGetBody(g) == hit->self) return;
+    geomInfo* gi = (geomInfo*)dGeomGetData(g);
+    if (gi && (!gi->collidable || gi->trigger)) return;
+
+    dContactGeom c;
+    if (dCollide(hit->ray, g, 1, &c, sizeof(dContactGeom)) && c.depth < hit->dist) {
+        hit->dist = c.depth;    // for rays depth is the distance from the start
+        hit->pos[0] = c.pos[0]; hit->pos[1] = c.pos[1]; hit->pos[2] = c.pos[2];
+        hit->normal[0] = c.normal[0]; hit->normal[1] = c.normal[1]; hit->normal[2] = c.normal[2];
+    }
+}
+
+static float dot3(const dReal* a, const dReal* b)
+{
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+// spring / damper suspension and a simple friction circle tire model,
+// all applied as forces on the chassis
+static void updateRaycastVehicle(vehicle *car, float accel, float maxAccelForce,
+                    float steer, float steerFactor)
+{
+    const VehicleDesc* d = &car->desc;
+    const float dt = car->slice;
+    dBodyID chassis = car->bodies[0];
+    const float travel = d->wheelDrop + d->wheelRadius;
+    // share of the vehicle mass each wheel has to stop sliding sideways
+    const float wheelShare = (d->chassisMass + d->wheelMass * 4) / 4;
+
+    // steering servo, same response as the hinge2 motor
+    car->steerAngle += (steer - car->steerAngle) * steerFactor * dt;
+    car->steerAngle = Clamp(car->steerAngle, -d->steerLimit, d->steerLimit);
+
+    const dReal* R = dBodyGetRotation(chassis);
+    dVector3 up = { R[1], R[5], R[9] };
+    const dReal* com = dBodyGetPosition(chassis);
+
+    for (int i = 0; i < 4; i++) {
+        dReal o[3];
+        dVector3 mount;
+        wheelOffset(d, i, o);
+        dBodyGetRelPointPos(chassis, o[0], 0, o[2], mount);
+
+        WheelHit hit = { car->geoms[i+1], chassis, travel, { 0 }, { 0 } };
+        dGeomRaySet(hit.ray, mount[0], mount[1], mount[2], -up[0], -up[1], -up[2]);
+        dSpaceCollide2(hit.ray, (dGeomID)car->space, &hit, &wheelRayCallback);
+
+        if (hit.dist >= travel) {
+            car->compression[i] = 0;    // wheel in the air
+            continue;
+        }
+        car->compression[i] = travel - hit.dist;
+
+        // suspension pushes along the chassis up axis
+        dVector3 pv;
+        dBodyGetPointVel(chassis, hit.pos[0], hit.pos[1], hit.pos[2], pv);
+        float springF = d->springRate * car->compression[i] - d->damping * dot3(pv, up);
+        if (springF < 0) springF = 0;   // a spring can't pull the car down
+        dBodyAddForceAtPos(chassis, up[0] * springF, up[1] * springF, up[2] * springF,
+                                    mount[0], mount[1], mount[2]);
+
+        // wheel heading, front pair steers
+        float a = (i < 2) ? car->steerAngle : 0;
+        dVector3 fwd, side;
+        dBodyVectorToWorld(chassis, cosf(a), 0, sinf(a), fwd);
+        // keep both in the contact plane
+        float fn = dot3(fwd, hit.normal);
+        for (int k = 0; k < 3; k++) fwd[k] -= hit.normal[k] * fn;
+        side[0] = hit.normal[1] * fwd[2] - hit.normal[2] * fwd[1];
+        side[1] = hit.normal[2] * fwd[0] - hit.normal[0] * fwd[2];
+        side[2] = hit.normal[0] * fwd[1] - hit.normal[1] * fwd[0];
+
+        // sideways - kill this wheel's share of the lateral slip
+        float latF = -dot3(pv, side) * wheelShare / dt;
+
+        // drive on the rear pair like the hinge2 car, accel is wheel spin (rad/s)
+        float lonF = 0;
+        if (i >= 2 && fabsf(accel) > 0.1f) {
+            float want = accel * d->wheelRadius - dot3(pv, fwd);
+            float maxF = maxAccelForce / d->wheelRadius;
+            lonF = Clamp(want * wheelShare / dt, -maxF, maxF);
+        }
+
+        // friction circle
+        float maxGrip = d->tireGrip * springF;
+        float tire = sqrtf(latF * latF + lonF * lonF);
+        if (tire > maxGrip && tire > 0) {
+            latF *= maxGrip / tire;
+            lonF *= maxGrip / tire;
+        }
+
+        // raising the application point towards the centre of mass
+        // stands in for the hinge2 car's anti roll counter weight
+        dVector3 at;
+        for (int k = 0; k < 3; k++) at[k] = hit.pos[k] + (com[k] - hit.pos[k]) * d->rollInfluence * fabsf(up[k]);
+        dBodyAddForceAtPos(chassis, side[0] * latF + fwd[0] * lonF,
+                                    side[1] * latF + fwd[1] * lonF,
+                                    side[2] * latF + fwd[2] * lonF, at[0], at[1], at[2]);
+    }
+}
+
 void updateVehicle(vehicle *car, float accel, float maxAccelForce,
                     float steer, float steerFactor)
 {
+    if (car->desc.model == VEHICLE_RAYCAST) {
+        updateRaycastVehicle(car, accel, maxAccelForce, steer, steerFactor);
+        return;
+    }
+
     float target;
     target = 0;
     if (fabs(accel) > 0.1) target = maxAccelForce;
@@ -163,6 +385,7 @@ void updateVehicle(vehicle *car, float accel, float maxAccelForce,
     //dJointSetHinge2Param( car->joints[1], dParamFMax2, target );
     dJointSetHinge2Param( car->joints[2], dParamFMax2, target );
     dJointSetHinge2Param( car->joints[3], dParamFMax2, target );
+    car->lastAccel = accel;
 
     for(int i=0;i<2;i++) {
         dReal v = steer - dJointGetHinge2Angle1 (car->joints[i]);
@@ -172,6 +395,39 @@ void updateVehicle(vehicle *car, float accel, float maxAccelForce,
 }
 
 
+void updateVehicles(vehicle **cars, const VehicleControl *controls, int count,
+                    float maxAccelForce, float steerFactor)
+{
+    for (int c = 0; c < count; c++) {
+        vehicle* car = cars[c];
+        float accel = controls[c].accel;
+
+        if (car->desc.model == VEHICLE_RAYCAST) {
+            updateRaycastVehicle(car, accel, maxAccelForce, controls[c].steer, steerFactor);
+            continue;
+        }
+
+        // drive motor params persist in the joints, only resend on change
+        if (accel != car->lastAccel) {
+            float target = (fabs(accel) > 0.1) ? maxAccelForce : 0;
+            dJointSetHinge2Param( car->joints[0], dParamVel2, -accel );
+            dJointSetHinge2Param( car->joints[1], dParamVel2, accel );
+            dJointSetHinge2Param( car->joints[2], dParamVel2, -accel );
+            dJointSetHinge2Param( car->joints[3], dParamVel2, accel );
+            dJointSetHinge2Param( car->joints[2], dParamFMax2, target );
+            dJointSetHinge2Param( car->joints[3], dParamFMax2, target );
+            car->lastAccel = accel;
+        }
+
+        // steering is a servo so it tracks the current angle every time
+        for(int i=0;i<2;i++) {
+            dReal v = controls[c].steer - dJointGetHinge2Angle1 (car->joints[i]);
+            dJointSetHinge2Param (car->joints[i],dParamVel,v * steerFactor);
+        }
+    }
+}
+
+
 void unflipVehicle (vehicle *car)
 {
     const dReal* cp = dBodyGetPosition(car->bodies[0]);
@@ -181,20 +437,50 @@ void unflipVehicle (vehicle *car)
     dReal newR[16];
     dRFromEulerAngles(newR, 0, -atan2(-R[2],R[0]) , 0);
     dBodySetRotation(car->bodies[0], newR);
-
-    // wheel offsets
-    // TODO make configurable & use in vehicle set up
-    dReal wheelOffsets[4][3] = {
-           { +1.2, -.6, -1 },
-           { +1.2, -.6, +1 },
-           { -1.2, -.6, -1 },
-           { -1.2, -.6, +1 }
-        };
+    if (car->desc.model == VEHICLE_RAYCAST) return;    // no wheel bodies to move
 
     for (int i=1; i<5; i++) {
+        dReal o[3];
         dVector3 pb;
-        dBodyGetRelPointPos(car->bodies[0], wheelOffsets[i-1][0], wheelOffsets[i-1][1], wheelOffsets[i-1][2], pb);
+        wheelOffset(&car->desc, i-1, o);
+        dBodyGetRelPointPos(car->bodies[0], o[0], o[1], o[2], pb);
         dBodySetPosition(car->bodies[i], pb[0], pb[1], pb[2]);
     }
 
 }
+
+
+void ResetVehicle(vehicle *car)
+{
+    placeVehicle(car, car->spawn);
+    for (int i = 0; i < 6; i++) {
+        if (!car->bodies[i]) continue;
+        dBodySetLinearVel(car->bodies[i], 0, 0, 0);
+        dBodySetAngularVel(car->bodies[i], 0, 0, 0);
+        dBodyEnable(car->bodies[i]);
+    }
+}
+
+
+void FreeVehicle(vehicle *car, PhysicsContext *ctx)
+{
+    if (!car) return;
+
+    for (int i = 0; i < 6; i++) {
+        if (car->joints[i]) dJointDestroy(car->joints[i]);
+        if (car->bodies[i]) ThawBody(ctx, car->bodies[i]);
+    }
+    for (int i = 0; i < 6; i++) {
+        if (car->geoms[i]) {
+            ContactCacheForgetGeom(&ctx->contacts, car->geoms[i]);
+            dGeomDestroy(car->geoms[i]);
+        }
+        if (!car->bodies[i]) continue;
+        TriggerForgetBody(&ctx->triggers, car->bodies[i]);
+        dBodyDestroy(car->bodies[i]);
+    }
+    ContactCacheForgetGeom(&ctx->contacts, car->cab);
+    dGeomDestroy(car->cab);
+
+    MemFree(car);
+}
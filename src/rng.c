@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include "rng.h"
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u       // key bumps, golden ratio and sqrt(3) - 1
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+static void philoxBlock(const uint32_t* counter, const uint32_t* seed, uint32_t* out)
+{
+    uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+    uint32_t k[2] = { seed[0], seed[1] };
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        const uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+        const uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+        const uint32_t n[4] = {
+            (uint32_t)(p1 >> 32) ^ c[1] ^ k[0], (uint32_t)p1,
+            (uint32_t)(p0 >> 32) ^ c[3] ^ k[1], (uint32_t)p0
+        };
+        c[0] = n[0]; c[1] = n[1]; c[2] = n[2]; c[3] = n[3];
+        k[0] += PHILOX_W0;
+        k[1] += PHILOX_W1;
+    }
+    out[0] = c[0]; out[1] = c[1]; out[2] = c[2]; out[3] = c[3];
+}
+
+void SeedRng(Rng* rng, unsigned long seed, uint32_t stream)
+{
+    rng->key[0] = (uint32_t)seed;
+    rng->key[1] = (uint32_t)((uint64_t)seed >> 32);
+    rng->counter[0] = 0;
+    rng->counter[1] = 0;
+    rng->counter[2] = stream;
+    rng->counter[3] = 0;
+    rng->used = 4;
+}
+
+uint32_t RngNext(Rng* rng)
+{
+    if (rng->used == 4) {
+        philoxBlock(rng->counter, rng->key, rng->block);
+        if (++rng->counter[0] == 0) rng->counter[1]++;
+        rng->used = 0;
+    }
+    return rng->block[rng->used++];
+}
+
+float RngFloat(Rng* rng, float min, float max)
+{
+    // the top 24 bits, all a float's mantissa can hold
+    const float f = (RngNext(rng) >> 8) * (1.0f / 16777216.0f);
+    // f is below 1 but scaled and offset it can still round up to max
+    const float r = f * (max - min) + min;
+    return (r >= max && max > min) ? nextafterf(max, min) : r;
+}
+
+int RngInt(Rng* rng, int n)
+{
+    return n > 0 ? (int)(((uint64_t)RngNext(rng) * (uint32_t)n) >> 32) : 0;
+}
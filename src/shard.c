@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "init.h"
+#include "memtrack.h"
+#include "shard.h"
+
+#define MAX_BODY_GEOMS 8    // compound objects have 3
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void* shardThread(void* data)
+{
+    ShardWorker* w = (ShardWorker*)data;
+    ShardSet* set = w->set;
+    unsigned int seen = 0;
+    dAllocateODEDataForThread(dAllocateMaskAll);
+
+    for (;;) {
+        pthread_mutex_lock(&set->lock);
+        while (set->generation == seen && !set->stopping) pthread_cond_wait(&set->wake, &set->lock);
+        if (set->stopping) {
+            pthread_mutex_unlock(&set->lock);
+            break;
+        }
+        seen = set->generation;
+        pthread_mutex_unlock(&set->lock);
+
+        for (int i = w->index; i < set->count; i += set->workerCount) {
+            Shard* s = &set->shards[i];
+            double t = nowSeconds();
+            StepPhysics(s->ctx, set->slice);
+            s->stepTime += nowSeconds() - t;
+        }
+
+        pthread_mutex_lock(&set->lock);
+        if (--set->pending == 0) pthread_cond_signal(&set->finished);
+        pthread_mutex_unlock(&set->lock);
+    }
+
+    dCleanupODEAllDataForThread();
+    return NULL;
+}
+
+static int shardAt(const ShardSet* set, float x)
+{
+    for (int i = 0; i < set->count - 1; i++) {
+        if (x < set->shards[i].maxX) return i;
+    }
+    return set->count - 1;
+}
+
+// which shard something at x should be in, s unless it's well past an edge
+static int shardFor(const ShardSet* set, int s, float x)
+{
+    const Shard* shard = &set->shards[s];
+    if (x >= shard->minX - SHARD_HYSTERESIS && x <= shard->maxX + SHARD_HYSTERESIS) return s;
+    return shardAt(set, x);
+}
+
+// a simple object, same as MoveRagdoll but no joints to worry about
+static dBodyID moveBody(dBodyID old, PhysicsContext* from, PhysicsContext* to)
+{
+    ThawBody(from, old);
+    dMass m;
+    dBodyGetMass(old, &m);
+    dBodyID b = dBodyCreate(to->world);
+    dBodySetMass(b, &m);
+    const dReal* p = dBodyGetPosition(old);
+    const dReal* v = dBodyGetLinearVel(old);
+    const dReal* w = dBodyGetAngularVel(old);
+    dBodySetPosition(b, p[0], p[1], p[2]);
+    dBodySetQuaternion(b, dBodyGetQuaternion(old));
+    dBodySetLinearVel(b, v[0], v[1], v[2]);
+    dBodySetAngularVel(b, w[0], w[1], w[2]);
+    dBodySetData(b, dBodyGetData(old));
+    if (!dBodyIsEnabled(old)) dBodyDisable(b);
+
+    // gathered first, changing body unlinks them from this one
+    dGeomID geoms[MAX_BODY_GEOMS];
+    int n = 0;
+    for (dGeomID g = dBodyGetFirstGeom(old); g && n < MAX_BODY_GEOMS; g = dBodyGetNextGeom(g)) geoms[n++] = g;
+    for (int i = 0; i < n; i++) {
+        dGeomID g = geoms[i];
+        const bool offset = dGeomIsOffset(g);
+        dVector3 op;
+        dMatrix3 orot;
+        if (offset) {
+            memcpy(op, dGeomGetOffsetPosition(g), sizeof(dVector3));
+            memcpy(orot, dGeomGetOffsetRotation(g), sizeof(dMatrix3));
+        }
+        dGeomSetBody(g, b);
+        if (offset) {
+            dGeomSetOffsetPosition(g, op[0], op[1], op[2]);
+            dGeomSetOffsetRotation(g, orot);
+        }
+        ContactCacheForgetGeom(&from->contacts, g);
+        dSpaceRemove(*from->space, g);
+        dSpaceAdd(*to->space, g);
+    }
+
+    TriggerForgetBody(&from->triggers, old);
+    dBodyDestroy(old);
+    return b;
+}
+
+static void migrate(ShardSet* set)
+{
+    for (int s = 0; s < set->count; s++) {
+        PhysicsContext* from = set->shards[s].ctx;
+
+        // an object keeps its slot, it's only ever in one shard's array
+        for (int i = 0; i < NUM_OBJ; i++) {
+            if (!from->obj[i]) continue;
+            int t = shardFor(set, s, dBodyGetPosition(from->obj[i])[0]);
+            if (t == s) continue;
+            PhysicsContext* to = set->shards[t].ctx;
+            to->obj[i] = moveBody(from->obj[i], from, to);
+            from->obj[i] = NULL;
+            set->migrations++;
+        }
+
+        for (int i = 0; i < from->ragdollCount; i++) {
+            RagDoll* rd = from->ragdolls[i];
+            if (!rd) continue;
+            int t = shardFor(set, s, rd->centerOfMass.x);
+            PhysicsContext* to = set->shards[t].ctx;
+            if (t == s || to->ragdollCount == MAX_RAGDOLLS) continue;
+            MoveRagdoll(rd, from, to);   // promotes a collapsed doll first
+            to->ragdolls[to->ragdollCount++] = rd;
+            from->ragdolls[i] = from->ragdolls[--from->ragdollCount];
+            from->ragdolls[from->ragdollCount] = NULL;
+            i--;
+            set->migrations++;
+        }
+    }
+}
+
+// only the shapes the scene is made of are ghosted
+static dGeomID cloneShape(dGeomID src, dSpaceID space)
+{
+    dReal r, l;
+    dVector3 len;
+    switch (dGeomGetClass(src)) {
+        case dSphereClass:
+            return dCreateSphere(space, dGeomSphereGetRadius(src));
+        case dBoxClass:
+            dGeomBoxGetLengths(src, len);
+            return dCreateBox(space, len[0], len[1], len[2]);
+        case dCapsuleClass:
+            dGeomCapsuleGetParams(src, &r, &l);
+            return dCreateCapsule(space, r, l);
+        case dCylinderClass:
+            dGeomCylinderGetParams(src, &r, &l);
+            return dCreateCylinder(space, r, l);
+    }
+    return NULL;
+}
+
+static void wantGhost(ShardSet* set, Shard* shard, int from, dGeomID src)
+{
+    Ghost* ghost = NULL;
+    for (int i = 0; i < shard->ghostCount && !ghost; i++) {
+        if (shard->ghosts[i].source == src) ghost = &shard->ghosts[i];
+    }
+
+    if (!ghost) {
+        if (shard->ghostCount == shard->ghostCapacity) {
+            int capacity = shard->ghostCapacity ? shard->ghostCapacity * 2 : 64;
+            Ghost* ghosts = MemRealloc(MEM_SPACES, shard->ghosts, capacity * sizeof(Ghost));
+            if (!ghosts) return;
+            shard->ghosts = ghosts;
+            shard->ghostCapacity = capacity;
+        }
+        dGeomID geom = cloneShape(src, shard->space);
+        if (!geom) return;
+        // made in syncGhosts' order, so the serial is the same every run
+        dGeomSetData(geom, CreateGeomInfo(shard->ctx, true, -1, 1.0f, 1.0f));
+        ghost = &shard->ghosts[shard->ghostCount++];
+        ghost->source = src;
+        ghost->from = from;
+        ghost->geom = geom;
+        ghost->body = dBodyCreate(shard->ctx->world);
+        dBodySetKinematic(ghost->body);
+        dGeomSetBody(geom, ghost->body);
+    }
+    ghost->stamp = set->stamp;
+
+    // the source geom's pose and the velocity of that point on its body
+    dBodyID b = dGeomGetBody(src);
+    const dReal* p = dGeomGetPosition(src);
+    const dReal* w = dBodyGetAngularVel(b);
+    dQuaternion q;
+    dVector3 v;
+    dGeomGetQuaternion(src, q);
+    dBodyGetPointVel(b, p[0], p[1], p[2], v);
+    dBodySetPosition(ghost->body, p[0], p[1], p[2]);
+    dBodySetQuaternion(ghost->body, q);
+    dBodySetLinearVel(ghost->body, v[0], v[1], v[2]);
+    dBodySetAngularVel(ghost->body, w[0], w[1], w[2]);
+    // a sleeping ghost doesn't keep the neighbour's sleeping bodies awake
+    if (dBodyIsEnabled(b)) {
+        dBodyEnable(ghost->body);
+    } else {
+        dBodyDisable(ghost->body);
+    }
+}
+
+static void dropGhost(Shard* shard, int i)
+{
+    Ghost* ghost = &shard->ghosts[i];
+    ThawBody(shard->ctx, ghost->body);
+    ContactCacheForgetGeom(&shard->ctx->contacts, ghost->geom);
+    FreeGeomInfo(ghost->geom);
+    dGeomDestroy(ghost->geom);
+    dBodyDestroy(ghost->body);
+    *ghost = shard->ghosts[--shard->ghostCount];
+}
+
+// a re-created doll can get the geoms (addresses) of the one it
+// replaced, so ghosts of anything from that shard can't be trusted
+static void dropGhostsFrom(ShardSet* set, int from)
+{
+    for (int s = 0; s < set->count; s++) {
+        Shard* shard = &set->shards[s];
+        for (int i = shard->ghostCount - 1; i >= 0; i--) {
+            if (shard->ghosts[i].from == from) dropGhost(shard, i);
+        }
+    }
+}
+
+static void syncGhosts(ShardSet* set)
+{
+    set->stamp++;
+    for (int s = 0; s < set->count; s++) {
+        Shard* shard = &set->shards[s];
+        int ng = dSpaceGetNumGeoms(shard->space);
+        for (int i = 0; i < ng; i++) {
+            dGeomID g = dSpaceGetGeom(shard->space, i);
+            dBodyID b = dGeomGetBody(g);
+            if (!b || dBodyIsKinematic(b)) continue;
+            dReal aabb[6];
+            dGeomGetAABB(g, aabb);
+            if (s > 0 && aabb[0] < shard->minX + SHARD_GHOST_MARGIN) wantGhost(set, &set->shards[s - 1], s, g);
+            if (s < set->count - 1 && aabb[1] > shard->maxX - SHARD_GHOST_MARGIN) wantGhost(set, &set->shards[s + 1], s, g);
+        }
+    }
+
+    // whatever moved away from an edge (or changed shard) this step
+    for (int s = 0; s < set->count; s++) {
+        Shard* shard = &set->shards[s];
+        for (int i = shard->ghostCount - 1; i >= 0; i--) {
+            if (shard->ghosts[i].stamp != set->stamp) dropGhost(shard, i);
+        }
+    }
+}
+
+bool InitShards(ShardSet* set, int count, int workers, float slice, unsigned long seed)
+{
+    memset(set, 0, sizeof(ShardSet));
+    set->slice = slice;
+    pthread_mutex_init(&set->lock, NULL);
+    pthread_mutex_init(&set->stepLock, NULL);
+    pthread_cond_init(&set->wake, NULL);
+    pthread_cond_init(&set->finished, NULL);
+
+    // the plane split evenly, anything off its ends in the outer shards
+    const float width = PLANE_SIZE / count;
+    for (int i = 0; i < count; i++) {
+        Shard* s = &set->shards[i];
+        s->minX = i ? -PLANE_SIZE / 2 + i * width : -INFINITY;
+        s->maxX = i < count - 1 ? -PLANE_SIZE / 2 + (i + 1) * width : INFINITY;
+        // the scene is made in the first and spreads out on the first step
+        s->ctx = i ? CreatePhysicsWorld(&s->space, seed) : InitPhysics(&s->space, seed);
+        if (!s->ctx) return false;
+        set->count++;
+        s->ctx->slice = slice;
+        // the first already used stream 0 to build the scene
+        if (i) SeedRng(&s->ctx->rng, seed, i);
+    }
+
+    // workers aren't started till every shard is there to be stepped
+    set->workerCount = (workers > 0 && workers < count) ? workers : count;
+    for (int i = 0; i < set->workerCount; i++) {
+        ShardWorker* w = &set->workers[i];
+        w->set = set;
+        w->index = i;
+        w->running = pthread_create(&w->thread, NULL, shardThread, w) == 0;
+        if (!w->running) return false;
+    }
+    return true;
+}
+
+void StepShards(ShardSet* set)
+{
+    // bodies only change world between steps, on this thread
+    migrate(set);
+    syncGhosts(set);
+
+    pthread_mutex_lock(&set->lock);
+    set->pending = set->workerCount;
+    set->generation++;
+    pthread_cond_broadcast(&set->wake);
+    while (set->pending) pthread_cond_wait(&set->finished, &set->lock);
+    pthread_mutex_unlock(&set->lock);
+
+    for (int s = 0; s < set->count; s++) {
+        PhysicsContext* ctx = set->shards[s].ctx;
+        unsigned int respawns = ctx->respawns;
+        ResetFallenObjects(ctx);
+        if (ctx->respawns != respawns) dropGhostsFrom(set, s);
+    }
+}
+
+void FreeShards(ShardSet* set)
+{
+    pthread_mutex_lock(&set->lock);
+    set->stopping = true;
+    pthread_cond_broadcast(&set->wake);
+    pthread_mutex_unlock(&set->lock);
+    for (int i = 0; i < set->workerCount; i++) {
+        if (set->workers[i].running) pthread_join(set->workers[i].thread, NULL);
+    }
+
+    for (int i = 0; i < set->count; i++) {
+        Shard* s = &set->shards[i];
+        while (s->ghostCount) dropGhost(s, s->ghostCount - 1);
+        MemFree(s->ghosts);
+        CleanupPhysics(s->ctx);
+        dSpaceDestroy(s->space);
+    }
+
+    pthread_cond_destroy(&set->finished);
+    pthread_cond_destroy(&set->wake);
+    pthread_mutex_destroy(&set->stepLock);
+    pthread_mutex_destroy(&set->lock);
+    set->count = 0;
+}
+
+int RunShards(const AppOptions* opts)
+{
+    const int count = opts->shards < SHARD_MAX ? opts->shards : SHARD_MAX;
+    if (opts->shmName || opts->benchVehicles) {
+        printf("shards: the shm controller and vehicle fleet aren't sharded, ignoring them\n");
+    }
+
+    ShardSet set;
+    if (!InitShards(&set, count, opts->workers, 1.0f / opts->physicsHz, opts->seed)) {
+        printf("shards: couldn't start %i shards\n", count);
+        FreeShards(&set);
+        return 1;
+    }
+    for (int i = 0; i < set.count; i++) {
+        PhysicsContext* ctx = set.shards[i].ctx;
+        ctx->ccd = opts->ccd;
+        ctx->deterministic = opts->deterministic;
+        ctx->stepLock = &set.stepLock;
+    }
+
+    const long steps = opts->steps > 0 ? opts->steps : opts->physicsHz * 60;
+    double start = nowSeconds();
+    for (long step = 0; step < steps; step++) StepShards(&set);
+    double wall = nowSeconds() - start;
+
+    printf("shards: %li steps (%.2f sim seconds) on %i shards, %i workers in %.3f s wall, %.3f ms/step\n",
+           steps, steps * set.slice, set.count, set.workerCount, wall, wall * 1000.0 / steps);
+    for (int i = 0; i < set.count; i++) {
+        const Shard* s = &set.shards[i];
+        int objects = 0;
+        for (int o = 0; o < NUM_OBJ; o++) objects += s->ctx->obj[o] != NULL;
+        printf("shards: %i  %i objects %i ragdolls %i ghosts  %.3f ms/step stepping\n",
+               i, objects, s->ctx->ragdollCount, s->ghostCount, s->stepTime * 1000.0 / steps);
+    }
+    // how far past one core it got, 1.0 is no better than stepping in turn
+    double stepping = 0;
+    for (int i = 0; i < set.count; i++) stepping += set.shards[i].stepTime;
+    printf("shards: %li migrations, %.2fx speedup over stepping the shards in turn\n",
+           set.migrations, wall > 0 ? stepping / wall : 0.0);
+    unsigned int hash = PHYSICS_HASH_START;
+    for (int i = 0; i < set.count; i++) hash = HashPhysicsState(set.shards[i].ctx, hash);
+    printf("shards: seed %lu, state hash %08x\n", opts->seed, hash);
+    MemPrintReport("shards:");
+
+    FreeShards(&set);
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "shmserver.h"
+
+// the sequence words are shared between processes so no FUTEX_PRIVATE_FLAG
+static bool futexWait(uint32_t* word, uint32_t val, int timeoutMs)
+{
+    struct timespec ts = { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+    long r = syscall(SYS_futex, word, FUTEX_WAIT, val, &ts, NULL, 0);
+    return !(r == -1 && errno == ETIMEDOUT);
+}
+
+static void futexWake(uint32_t* word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+}
+
+static uint32_t alignUp(uint32_t v)
+{
+    return (v + 63u) & ~63u;    // keep the float arrays on their own cache lines
+}
+
+bool ShmServerOpen(ShmServer* srv, const char* name, PhysicsContext* ctx, float stepSize)
+{
+    memset(srv, 0, sizeof(ShmServer));
+    srv->fd = -1;
+
+    // shm_open wants a leading slash, accept names with or without
+    snprintf(srv->name, sizeof(srv->name), "%s%s", name[0] == '/' ? "" : "/", name);
+
+    uint32_t obsPer = RAGDOLL_BODY_COUNT * SHM_OBS_PER_BODY;
+    uint32_t actPer = RAGDOLL_JOINT_COUNT * 2;   // see UpdateRagdollMotors
+    uint32_t obsOffset = alignUp(sizeof(ShmControlHeader));
+    uint32_t actOffset = alignUp(obsOffset + MAX_RAGDOLLS * obsPer * sizeof(float));
+    uint32_t total = alignUp(actOffset + MAX_RAGDOLLS * actPer * sizeof(float));
+
+    // a stale segment from a crashed run would have old handshake state
+    shm_unlink(srv->name);
+    srv->fd = shm_open(srv->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (srv->fd < 0) {
+        printf("shm: can't create %s (%s)\n", srv->name, strerror(errno));
+        return false;
+    }
+    if (ftruncate(srv->fd, total) != 0) {
+        printf("shm: can't size %s (%s)\n", srv->name, strerror(errno));
+        ShmServerClose(srv);
+        return false;
+    }
+    void* mem = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, srv->fd, 0);
+    if (mem == MAP_FAILED) {
+        printf("shm: can't map %s (%s)\n", srv->name, strerror(errno));
+        ShmServerClose(srv);
+        return false;
+    }
+    memset(mem, 0, total);
+
+    srv->hdr = (ShmControlHeader*)mem;
+    srv->hdr->version = SHM_CONTROL_VERSION;
+    srv->hdr->ragdollCount = ctx->ragdollCount;
+    srv->hdr->bodiesPerRagdoll = RAGDOLL_BODY_COUNT;
+    srv->hdr->torsoBody = RAGDOLL_TORSO;
+    srv->hdr->obsPerRagdoll = obsPer;
+    srv->hdr->actPerRagdoll = actPer;
+    srv->hdr->obsOffset = obsOffset;
+    srv->hdr->actOffset = actOffset;
+    srv->hdr->totalSize = total;
+    srv->hdr->stepSize = stepSize;
+    srv->hdr->state = SHM_STATE_RUNNING;
+    // magic last so a client polling for it sees a complete header
+    __atomic_store_n(&srv->hdr->magic, SHM_CONTROL_MAGIC, __ATOMIC_RELEASE);
+
+    printf("shm: serving %i ragdolls on %s (%u bytes)\n", ctx->ragdollCount, srv->name, total);
+    return true;
+}
+
+static void writeObservations(ShmControlHeader* hdr, PhysicsContext* ctx)
+{
+    float* obs = SHM_OBSERVATIONS(hdr);
+
+    for (int i = 0; i < ctx->ragdollCount; i++) {
+        float* o = obs + i * hdr->obsPerRagdoll;
+        RagDoll* rd = ctx->ragdolls[i];
+        if (!rd) {
+            memset(o, 0, hdr->obsPerRagdoll * sizeof(float));
+            continue;
+        }
+        for (int b = 0; b < rd->bodyCount; b++, o += SHM_OBS_PER_BODY) {
+            const dReal* p = dBodyGetPosition(rd->bodies[b]);
+            const dReal* q = dBodyGetQuaternion(rd->bodies[b]);
+            const dReal* lv = dBodyGetLinearVel(rd->bodies[b]);
+            const dReal* av = dBodyGetAngularVel(rd->bodies[b]);
+            o[0] = p[0];  o[1] = p[1];  o[2] = p[2];
+            o[3] = q[0];  o[4] = q[1];  o[5] = q[2];  o[6] = q[3];
+            o[7] = lv[0]; o[8] = lv[1]; o[9] = lv[2];
+            o[10] = av[0]; o[11] = av[1]; o[12] = av[2];
+        }
+    }
+}
+
+bool ShmServerExchange(ShmServer* srv, PhysicsContext* ctx, uint64_t step)
+{
+    ShmControlHeader* hdr = srv->hdr;
+
+    writeObservations(hdr, ctx);
+    hdr->step = step;
+    uint32_t seq = __atomic_add_fetch(&hdr->obsSeq, 1, __ATOMIC_RELEASE);
+    futexWake(&hdr->obsSeq);
+
+    // wait for the client to answer this observation
+    for (;;) {
+        if (__atomic_load_n(&hdr->state, __ATOMIC_ACQUIRE) == SHM_STATE_SHUTDOWN) return false;
+        uint32_t act = __atomic_load_n(&hdr->actSeq, __ATOMIC_ACQUIRE);
+        if (act == seq) break;
+        // time out now and again so a shutdown request, or a client
+        // that died without making one, is noticed
+        if (futexWait(&hdr->actSeq, act, 1000)) continue;
+        uint32_t pid = __atomic_load_n(&hdr->clientPid, __ATOMIC_ACQUIRE);
+        if (pid && kill((pid_t)pid, 0) != 0 && errno == ESRCH) {
+            printf("shm: client %u went away\n", pid);
+            return false;
+        }
+    }
+
+    float* acts = SHM_ACTIONS(hdr);
+    for (int i = 0; i < ctx->ragdollCount; i++) {
+        if (ctx->ragdolls[i]) {
+            UpdateRagdollMotors(ctx->ragdolls[i], acts + i * hdr->actPerRagdoll);
+        }
+    }
+    return true;
+}
+
+void ShmServerClose(ShmServer* srv)
+{
+    if (srv->hdr) {
+        // let a waiting client know we've gone
+        __atomic_store_n(&srv->hdr->state, SHM_STATE_SHUTDOWN, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&srv->hdr->obsSeq, 1, __ATOMIC_RELEASE);
+        futexWake(&srv->hdr->obsSeq);
+        munmap(srv->hdr, srv->hdr->totalSize);
+        srv->hdr = NULL;
+    }
+    if (srv->fd >= 0) {
+        close(srv->fd);
+        shm_unlink(srv->name);
+        srv->fd = -1;
+    }
+}
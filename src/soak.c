@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "raylibODEragdoll.h"
+#include "init.h"
+#include "memtrack.h"
+#include "soak.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// resident set from /proc, 0 if it can't be read
+static size_t residentBytes(void)
+{
+    long pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return (size_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+// move a group of bodies (together, so joints stay happy) out past the
+// edge of the plane, from where they fall into the kill volume
+static void dropOffPlane(dBodyID* bodies, int count, Rng* rng)
+{
+    const dReal* p = dBodyGetPosition(bodies[0]);
+    const float side = RngInt(rng, 2) ? -1 : 1;
+    const dReal offset[3] = { side * (PLANE_SIZE / 2 + 5) - p[0], 2 - p[1], 0 };
+    for (int i = 0; i < count; i++) {
+        const dReal* b = dBodyGetPosition(bodies[i]);
+        dBodySetPosition(bodies[i], b[0] + offset[0], b[1] + offset[1], b[2] + offset[2]);
+        dBodySetLinearVel(bodies[i], 0, 0, 0);
+        dBodySetAngularVel(bodies[i], 0, 0, 0);
+        dBodyEnable(bodies[i]);
+    }
+}
+
+typedef struct SoakSample {
+    size_t rss;
+    size_t live;            // memtrack's total
+    long allocs;
+    double stepMs;
+} SoakSample;
+
+int RunSoak(const AppOptions* opts)
+{
+    dSpaceID space;
+    PhysicsContext* physCtx = InitPhysics(&space, opts->seed);
+    if (!physCtx) return 1;
+    physCtx->slice = 1.0f / opts->physicsHz;
+    physCtx->ccd = opts->ccd;
+    physCtx->ragdollLod = opts->ragdollLod;
+
+    printf("soak: %i minutes, %.1f respawns per second, fail on %i KB growth or %i%% step time drift, seed %lu\n",
+           opts->soakMinutes, opts->soakChurn, opts->soakMaxGrowthKB, opts->soakMaxDrift, opts->seed);
+
+    const double end = nowSeconds() + opts->soakMinutes * 60.0;
+    const int stepsPerDrop = (opts->soakChurn > 0) ? (int)(1.0f / (opts->soakChurn * physCtx->slice)) : 0;
+    double nextSample = nowSeconds() + SOAK_SAMPLE_SECONDS;
+    double stepTime = 0;
+    long stepsSince = 0, step = 0, drops = 0;
+    int samples = 0, memoryStrikes = 0, timeStrikes = 0;
+    SoakSample base = { 0 };
+    bool failed = false;
+
+    while (!failed && nowSeconds() < end) {
+        // alternate between the simple objects and the dolls
+        if (stepsPerDrop > 0 && step % stepsPerDrop == 0) {
+            if ((drops & 1) && physCtx->ragdollCount) {
+                RagDoll* rd = physCtx->ragdolls[RngInt(&physCtx->rng, physCtx->ragdollCount)];
+                if (rd && rd->proxy) dropOffPlane(&rd->proxy, 1, &physCtx->rng);
+                else if (rd) dropOffPlane(rd->bodies, rd->bodyCount, &physCtx->rng);
+            } else {
+                dropOffPlane(&physCtx->obj[RngInt(&physCtx->rng, NUM_OBJ)], 1, &physCtx->rng);
+            }
+            drops++;
+        }
+
+        double t = nowSeconds();
+        StepPhysics(physCtx, physCtx->slice);
+        stepTime += nowSeconds() - t;
+        stepsSince++;
+        step++;
+
+        ResetFallenObjects(physCtx);
+
+        if (t < nextSample) continue;
+        nextSample += SOAK_SAMPLE_SECONDS;
+
+        MemStats ms;
+        MemGetStats(&ms);
+        SoakSample s = { residentBytes(), ms.liveTotal, ms.allocs, stepTime * 1000.0 / stepsSince };
+        stepTime = 0;
+        stepsSince = 0;
+        samples++;
+
+        if (samples == SOAK_WARMUP_SAMPLES) base = s;
+        const long rssGrowth = (long)(s.rss - base.rss) / 1024;
+        const long liveGrowth = (long)(s.live - base.live) / 1024;
+        const double drift = (base.stepMs > 0) ? (s.stepMs / base.stepMs - 1) * 100 : 0;
+        printf("soak: %6.1f min  %9li steps  %6li drops  rss %7zu KB (%+li)  live %7zu KB (%+li)  %9li allocs  %.3f ms/step (%+.0f%%)\n",
+               (opts->soakMinutes * 60.0 - (end - nowSeconds())) / 60.0, step, drops,
+               s.rss / 1024, samples > SOAK_WARMUP_SAMPLES ? rssGrowth : 0,
+               s.live / 1024, samples > SOAK_WARMUP_SAMPLES ? liveGrowth : 0,
+               s.allocs, s.stepMs, samples > SOAK_WARMUP_SAMPLES ? drift : 0);
+        fflush(stdout);
+        if (samples <= SOAK_WARMUP_SAMPLES) continue;
+
+        // one bad sample is noise (allocator arenas, a busy machine),
+        // several in a row is a trend
+        bool grew = rssGrowth > opts->soakMaxGrowthKB || liveGrowth > opts->soakMaxGrowthKB;
+        memoryStrikes = grew ? memoryStrikes + 1 : 0;
+        timeStrikes = (drift > opts->soakMaxDrift) ? timeStrikes + 1 : 0;
+        if (memoryStrikes >= SOAK_STRIKES) {
+            printf("soak: FAILED, memory grew by more than %i KB\n", opts->soakMaxGrowthKB);
+            failed = true;
+        }
+        if (timeStrikes >= SOAK_STRIKES) {
+            printf("soak: FAILED, step time drifted more than %i%%\n", opts->soakMaxDrift);
+            failed = true;
+        }
+    }
+
+    if (!failed) printf("soak: passed, %li steps, %li drops\n", step, drops);
+    MemPrintReport("soak:");
+
+    CleanupPhysics(physCtx);
+    dSpaceDestroy(space);
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "raylib.h"
+#include <ode/ode.h>
+#include "stepmemory.h"
+#include "memtrack.h"
+
+// ODE's memory callbacks don't take a user pointer, the world being
+// stepped on this thread is the one asking
+static __thread StepMemory* stepping = NULL;
+
+static void* allocBlock(dsizeint size)
+{
+    if (stepping) {
+        stepping->allocs++;
+        if (stepping->warmup == 0) {
+            if (stepping->growing) stepping->growing = false;
+            else stepping->lateAllocs++;
+        }
+        stepping->blockSize = size;
+        if (size > stepping->peakBlock) stepping->peakBlock = size;
+    }
+    return MemAlloc(MEM_STEP, size);
+}
+
+// the block is kept at its size, giving it back only for ODE to ask
+// again next step is the traffic this is here to stop
+static void* shrinkBlock(void* block, dsizeint size, dsizeint smaller)
+{
+    (void)size;
+    (void)smaller;
+    return block;
+}
+
+static void freeBlock(void* block, dsizeint size)
+{
+    (void)size;
+    MemFree(block);
+}
+
+void InitStepMemory(StepMemory* mem, dWorldID world)
+{
+    memset(mem, 0, sizeof(StepMemory));
+    mem->warmup = STEP_MEMORY_WARMUP;
+
+    dWorldStepMemoryFunctionsInfo funcs = { sizeof(funcs), allocBlock, shrinkBlock, freeBlock };
+    dWorldSetStepMemoryManager(world, &funcs);
+}
+
+void StepMemoryBegin(StepMemory* mem)
+{
+    stepping = mem;
+}
+
+// contact joints live in the group's obstack, which keeps its arenas
+// when emptied, so creating and dropping a batch leaves it that big
+static void reserveContacts(StepMemory* mem, dWorldID world, dJointGroupID group, int count)
+{
+    dContact dummy;
+    memset(&dummy, 0, sizeof(dummy));
+    MemTag tag = MemSetTag(MEM_CONTACTS);
+    for (int i = 0; i < count; i++) dJointCreateContact(world, group, &dummy);
+    dJointGroupEmpty(group);
+    MemSetTag(tag);
+    mem->reservedContacts = count;
+}
+
+void StepMemoryEnd(StepMemory* mem, dWorldID world, dJointGroupID group, int contacts)
+{
+    stepping = NULL;
+    if (contacts > mem->peakContacts) mem->peakContacts = contacts;
+
+    if (mem->warmup == 0 || --mem->warmup > 0) return;
+
+    // ODE grows the block to the minimum at the start of the next step,
+    // the last allocation it should need
+    dWorldStepReserveInfo info = { sizeof(info), 1.2f,
+                                   (unsigned)(mem->peakBlock * STEP_MEMORY_HEADROOM) };
+    dWorldSetStepMemoryReservationPolicy(world, &info);
+
+    int count = (int)(mem->peakContacts * STEP_MEMORY_HEADROOM);
+    if (count < STEP_MEMORY_MIN_CONTACTS) count = STEP_MEMORY_MIN_CONTACTS;
+    reserveContacts(mem, world, group, count);
+    mem->growing = info.reserve_minimum > mem->blockSize;
+
+    printf("step memory: peak %zu KB working memory, %i contacts, reserved %zu KB and %i contacts\n",
+           mem->peakBlock / 1024, mem->peakContacts, (size_t)info.reserve_minimum / 1024, count);
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "raylib.h"
+
+#include <ode/ode.h>
+#include "raylibODE.h"
+#include "trigger.h"
+#include "memtrack.h"
+
+// grow a body array to hold at least n entries, false (and the array
+// as it was) if it can't
+static bool reserveBodies(dBodyID** arr, int* cap, int n)
+{
+    if (n <= *cap) return true;
+    int newCap = *cap ? *cap * 2 : 32;
+    while (newCap < n) newCap *= 2;
+    dBodyID* bodies = MemRealloc(MEM_TRIGGERS, *arr, newCap * sizeof(dBodyID));
+    if (!bodies) return false;
+    *arr = bodies;
+    *cap = newCap;
+    return true;
+}
+
+// out of memory the event is lost, the body stays where it was
+static void pushEvent(TriggerSystem* sys, TriggerEventType type, int id, dBodyID body)
+{
+    if (sys->eventCount == sys->eventCap) {
+        int capacity = sys->eventCap ? sys->eventCap * 2 : 64;
+        TriggerEvent* events = MemRealloc(MEM_TRIGGERS, sys->events, capacity * sizeof(TriggerEvent));
+        if (!events) return;
+        sys->events = events;
+        sys->eventCap = capacity;
+    }
+    sys->events[sys->eventCount++] = (TriggerEvent){ type, id, body };
+}
+
+static int compareBodies(const void* a, const void* b)
+{
+    const uintptr_t pa = (uintptr_t)*(const dBodyID*)a;
+    const uintptr_t pb = (uintptr_t)*(const dBodyID*)b;
+    return (pa > pb) - (pa < pb);
+}
+
+// the step's events in an order that doesn't depend on addresses, so
+// whatever they're handled with (respawns drawing from the rng) repeats
+static int compareEvents(const void* a, const void* b)
+{
+    const TriggerEvent* ea = (const TriggerEvent*)a;
+    const TriggerEvent* eb = (const TriggerEvent*)b;
+    if (ea->type != eb->type) return ea->type < eb->type ? -1 : 1;
+    return CompareBodyOrder(ea->body, eb->body);
+}
+
+TriggerVolume* CreateTriggerBox(TriggerSystem* sys, dSpaceID space, int id, Vector3 position, Vector3 size)
+{
+    if (sys->count >= MAX_TRIGGERS) return NULL;
+
+    TriggerVolume* t = MemCalloc(MEM_TRIGGERS, 1, sizeof(TriggerVolume));
+    if (!t) return NULL;
+    t->id = id;
+    MemTag tag = MemSetTag(MEM_TRIGGERS);
+    t->geom = dCreateBox(space, size.x, size.y, size.z);
+    MemSetTag(tag);
+    dGeomSetPosition(t->geom, position.x, position.y, position.z);
+
+    // not collidable (so never drawn or contacted) but flagged as a sensor,
+    // no serial, volumes are static and ordered by where they are
+    geomInfo* gi = CreateGeomInfo(NULL, false, -1, 1.0f, 1.0f);
+    gi->trigger = t;
+    dGeomSetData(t->geom, gi);
+
+    sys->volumes[sys->count++] = t;
+    return t;
+}
+
+void TriggerBeginStep(TriggerSystem* sys)
+{
+    for (int i = 0; i < sys->count; i++) {
+        sys->volumes[i]->touchingCount = 0;
+    }
+}
+
+static void touch(TriggerVolume* t, dGeomID trigger, dGeomID other)
+{
+    dBodyID b = dGeomGetBody(other);
+    if (!b) return;     // static world geometry isn't interesting
+
+    // broadphase only says the AABBs overlap, make sure the shapes do
+    dContactGeom c;
+    if (!dCollide(trigger, other, 1, &c, sizeof(dContactGeom))) return;
+
+    if (!reserveBodies(&t->touching, &t->touchingCap, t->touchingCount + 1)) return;
+    t->touching[t->touchingCount++] = b;
+}
+
+bool TriggerCollide(dGeomID o1, dGeomID o2)
+{
+    geomInfo* gi1 = (geomInfo*)dGeomGetData(o1);
+    geomInfo* gi2 = (geomInfo*)dGeomGetData(o2);
+    TriggerVolume* t1 = gi1 ? gi1->trigger : NULL;
+    TriggerVolume* t2 = gi2 ? gi2->trigger : NULL;
+
+    if (t1 && t2) return true;  // overlapping sensors don't care about each other
+    if (t1) touch(t1, o1, o2);
+    else if (t2) touch(t2, o2, o1);
+
+    return t1 || t2;
+}
+
+void TriggerEndStep(TriggerSystem* sys)
+{
+    for (int v = 0; v < sys->count; v++) {
+        TriggerVolume* t = sys->volumes[v];
+
+        // compound bodies report once per geom
+        qsort(t->touching, t->touchingCount, sizeof(dBodyID), compareBodies);
+        int n = 0;
+        for (int i = 0; i < t->touchingCount; i++) {
+            if (!n || t->touching[n-1] != t->touching[i]) t->touching[n++] = t->touching[i];
+        }
+        t->touchingCount = n;
+
+        // a body that fell asleep inside can't have left, keep it even
+        // if the space didn't report the pair this step
+        for (int i = 0; i < t->insideCount; i++) {
+            dBodyID b = t->inside[i];
+            if (dBodyIsEnabled(b)) continue;
+            if (!bsearch(&b, t->touching, t->touchingCount, sizeof(dBodyID), compareBodies)) {
+                if (!reserveBodies(&t->touching, &t->touchingCap, t->touchingCount + 1)) continue;
+                t->touching[t->touchingCount++] = b;
+                qsort(t->touching, t->touchingCount, sizeof(dBodyID), compareBodies);
+            }
+        }
+
+        // both lists sorted, walk them together for the differences
+        const int first = sys->eventCount;
+        int i = 0, j = 0;
+        while (i < t->insideCount || j < t->touchingCount) {
+            if (j == t->touchingCount ||
+                    (i < t->insideCount && compareBodies(&t->inside[i], &t->touching[j]) < 0)) {
+                pushEvent(sys, TRIGGER_EXIT, t->id, t->inside[i++]);
+            } else if (i == t->insideCount ||
+                    compareBodies(&t->inside[i], &t->touching[j]) > 0) {
+                pushEvent(sys, TRIGGER_ENTER, t->id, t->touching[j++]);
+            } else {
+                i++;
+                j++;
+            }
+        }
+        qsort(sys->events + first, sys->eventCount - first, sizeof(TriggerEvent), compareEvents);
+
+        // this step's overlaps become the new inside set
+        dBodyID* tmp = t->inside;
+        int tmpCap = t->insideCap;
+        t->inside = t->touching;
+        t->insideCap = t->touchingCap;
+        t->insideCount = t->touchingCount;
+        t->touching = tmp;
+        t->touchingCap = tmpCap;
+        t->touchingCount = 0;
+    }
+}
+
+bool PollTriggerEvent(TriggerSystem* sys, TriggerEvent* ev)
+{
+    while (sys->eventRead < sys->eventCount) {
+        *ev = sys->events[sys->eventRead++];
+        if (ev->body) return true;
+    }
+    // drained, start again at the front
+    sys->eventRead = sys->eventCount = 0;
+    return false;
+}
+
+void TriggerForgetBody(TriggerSystem* sys, dBodyID body)
+{
+    for (int v = 0; v < sys->count; v++) {
+        TriggerVolume* t = sys->volumes[v];
+        dBodyID* found = bsearch(&body, t->inside, t->insideCount, sizeof(dBodyID), compareBodies);
+        if (found) {
+            int idx = found - t->inside;
+            for (int i = idx; i < t->insideCount - 1; i++) t->inside[i] = t->inside[i+1];
+            t->insideCount--;
+        }
+    }
+    // events already queued for it can't be acted on
+    for (int i = sys->eventRead; i < sys->eventCount; i++) {
+        if (sys->events[i].body == body) sys->events[i].body = NULL;
+    }
+}
+
+void FreeTriggers(TriggerSystem* sys)
+{
+    for (int i = 0; i < sys->count; i++) {
+        TriggerVolume* t = sys->volumes[i];
+        FreeGeomInfo(t->geom);
+        dGeomDestroy(t->geom);
+        MemFree(t->inside);
+        MemFree(t->touching);
+        MemFree(t);
+    }
+    MemFree(sys->events);
+    sys->events = NULL;
+    sys->count = sys->eventCount = sys->eventCap = sys->eventRead = 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "raylib.h"
+#include "xform.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define XFORM_SSE
+#endif
+
+// raylib's Matrix is stored row by row (m0 m4 m8 m12, m1 ...) and so is
+// ODE's dMatrix3, so each output row is an ODE row times the scale with
+// the matching position component in the 4th lane
+void BuildModelMatricesScalar(const float* positions, const float* rotations,
+                              const Vector3* scales, Matrix* out, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const float* p = &positions[i * 4];
+        const float* R = &rotations[i * 12];
+        const Vector3 s = scales[i];
+        Matrix* m = &out[i];
+        m->m0 = R[0] * s.x;  m->m4 = R[1] * s.y;  m->m8 = R[2] * s.z;    m->m12 = p[0];
+        m->m1 = R[4] * s.x;  m->m5 = R[5] * s.y;  m->m9 = R[6] * s.z;    m->m13 = p[1];
+        m->m2 = R[8] * s.x;  m->m6 = R[9] * s.y;  m->m10 = R[10] * s.z;  m->m14 = p[2];
+        m->m3 = 0;           m->m7 = 0;           m->m11 = 0;            m->m15 = 1;
+    }
+}
+
+void BuildModelMatrices(const float* positions, const float* rotations,
+                        const Vector3* scales, Matrix* out, int count)
+{
+#ifdef XFORM_SSE
+    // the ODE row padding isn't guaranteed to be zero (or a number)
+    const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    const __m128 w = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    const __m128 lastRow = _mm_set_ps(1, 0, 0, 0);
+
+    for (int i = 0; i < count; i++) {
+        const float* R = &rotations[i * 12];
+        const __m128 p = _mm_loadu_ps(&positions[i * 4]);
+        const __m128 s = _mm_set_ps(0, scales[i].z, scales[i].y, scales[i].x);
+        float* m = (float*)&out[i];
+
+        __m128 r0 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R), s), xyz);
+        __m128 r1 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R + 4), s), xyz);
+        __m128 r2 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R + 8), s), xyz);
+        r0 = _mm_or_ps(r0, _mm_and_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)), w));
+        r1 = _mm_or_ps(r1, _mm_and_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), w));
+        r2 = _mm_or_ps(r2, _mm_and_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), w));
+
+        _mm_storeu_ps(m, r0);
+        _mm_storeu_ps(m + 4, r1);
+        _mm_storeu_ps(m + 8, r2);
+        _mm_storeu_ps(m + 12, lastRow);
+    }
+#else
+    BuildModelMatricesScalar(positions, rotations, scales, out, count);
+#endif
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Chris Camacho (codifies -  http://bedroomcoders.co.uk/)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+// Reference controller for the headless shared memory server
+//
+//   ./RayLibOdeRagDoll --headless --shm ragdoll &
+//   ./shmclient ragdoll 2400
+//
+// drives every joint with a slow sine wave, it only needs shmserver.h
+// so it's a template for clients in other languages too - map the
+// segment, follow the sequence counters described in the header
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "shmserver.h"
+
+static void futexWait(uint32_t* word, uint32_t val, int timeoutMs)
+{
+    struct timespec ts = { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static void futexWake(uint32_t* word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        printf("usage: %s NAME [steps]\n", argv[0]);
+        return 1;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s%s", argv[1][0] == '/' ? "" : "/", argv[1]);
+    long maxSteps = argc > 2 ? atol(argv[2]) : 0;
+
+    // wait for the sim to create the segment
+    int fd = -1;
+    for (int tries = 0; fd < 0 && tries < 100; tries++) {
+        fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) usleep(100000);
+    }
+    if (fd < 0) {
+        printf("can't open %s (%s)\n", name, strerror(errno));
+        return 1;
+    }
+
+    // it can be opened before the sim has sized it
+    struct stat st = { 0 };
+    for (int tries = 0; tries < 100; tries++) {
+        if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(ShmControlHeader)) break;
+        usleep(100000);
+    }
+    if (st.st_size < (off_t)sizeof(ShmControlHeader)) {
+        printf("%s was never sized\n", name);
+        close(fd);
+        return 1;
+    }
+    ShmControlHeader* hdr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (hdr == MAP_FAILED) {
+        printf("can't map %s\n", name);
+        return 1;
+    }
+    // and sized before the header is filled in, magic goes in last
+    int waited = 0;
+    while (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_CONTROL_MAGIC && waited++ < 10000) usleep(1000);
+    if (hdr->magic != SHM_CONTROL_MAGIC || hdr->version != SHM_CONTROL_VERSION) {
+        printf("bad header, magic %08x version %u (want %u)\n", hdr->magic, hdr->version, SHM_CONTROL_VERSION);
+        munmap(hdr, st.st_size);
+        return 1;
+    }
+    __atomic_store_n(&hdr->clientPid, (uint32_t)getpid(), __ATOMIC_RELEASE);
+    printf("%u ragdolls, %u obs / %u actions each, dt %f\n", hdr->ragdollCount,
+                hdr->obsPerRagdoll, hdr->actPerRagdoll, hdr->stepSize);
+
+    uint32_t seen = 0;
+    long steps = 0;
+    while (maxSteps <= 0 || steps < maxSteps) {
+        uint32_t seq = __atomic_load_n(&hdr->obsSeq, __ATOMIC_ACQUIRE);
+        if (seq == seen) {
+            futexWait(&hdr->obsSeq, seq, 1000);
+            continue;
+        }
+        if (__atomic_load_n(&hdr->state, __ATOMIC_ACQUIRE) == SHM_STATE_SHUTDOWN) break;
+
+        const float* obs = SHM_OBSERVATIONS(hdr);
+        float* act = SHM_ACTIONS(hdr);
+        float t = hdr->step * hdr->stepSize;
+        for (uint32_t r = 0; r < hdr->ragdollCount; r++) {
+            // torso height, just to show where the observations are
+            const float* torso = obs + r * hdr->obsPerRagdoll + hdr->torsoBody * SHM_OBS_PER_BODY;
+            float* a = act + r * hdr->actPerRagdoll;
+            for (uint32_t j = 0; j < hdr->actPerRagdoll; j++) {
+                a[j] = torso[1] > 0.5f ? sinf(t * 2.0f + j) * 2.0f : 0.0f;
+            }
+        }
+
+        seen = seq;
+        __atomic_store_n(&hdr->actSeq, seq, __ATOMIC_RELEASE);
+        futexWake(&hdr->actSeq);
+        steps++;
+    }
+
+    // tell the sim we're done
+    __atomic_store_n(&hdr->state, SHM_STATE_SHUTDOWN, __ATOMIC_RELEASE);
+    futexWake(&hdr->actSeq);
+    munmap(hdr, st.st_size);
+
+    printf("client ran %li steps\n", steps);
+    return 0;
+}